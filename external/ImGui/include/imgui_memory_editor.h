@@ -51,6 +51,7 @@
 #include <hex/api/event.hpp>
 
 #include <string>
+#include <vector>
 
 #ifdef _MSC_VER
 #define _PRISizeT   "I"
@@ -83,6 +84,12 @@ struct MemoryEditor
         ImColor color;
     };
 
+    struct DecodedCell {
+        size_t addr;
+        DecodeData decoded;
+        float width;
+    };
+
     // Settings
     bool            ReadOnly;                                   // = false  // disable any editing.
     int             Cols;                                       // = 16     // number of columns to display.
@@ -95,11 +102,12 @@ struct MemoryEditor
     int             OptMidColsCount;                            // = 8      // set to 0 to disable extra spacing between every mid-cols.
     int             OptAddrDigitsCount;                         // = 0      // number of addr digits to display (default calculated based on maximum displayed addr).
     ImU32           HighlightColor;                             //          // background color of highlighted bytes.
-    ImU8            (*ReadFn)(const ImU8* data, size_t off);    // = 0      // optional handler to read bytes.
+    void            (*ReadFn)(const ImU8* data, size_t off, ImU8* buffer, size_t size); // = 0  // optional handler to read bytes. called once per frame for all visible rows.
     void            (*WriteFn)(ImU8* data, size_t off, ImU8 d); // = 0      // optional handler to write bytes.
-    bool            (*HighlightFn)(const ImU8* data, size_t off, bool next);//= 0      // optional handler to return Highlight property (to support non-contiguous highlighting).
+    void            (*HighlightFn)(const ImU8* data, size_t off, ImU32* colors, size_t size); // = 0  // optional handler to fill in the highlight color of every visible byte, 0 for none (to support non-contiguous highlighting).
     void            (*HoverFn)(const ImU8 *data, size_t off);
-    DecodeData      (*DecodeFn)(const ImU8 *data, size_t off);
+    DecodeData      (*DecodeFn)(const ImU8 *data, size_t off, const ImU8 *bytes, size_t size);
+    size_t          DecodeLookahead;                            // = 0      // number of bytes past the last visible row that DecodeFn may look at.
 
     // [Internal State]
     bool            ContentsWidthChanged;
@@ -115,6 +123,10 @@ struct MemoryEditor
     size_t          HighlightMin, HighlightMax;
     int             PreviewEndianess;
     ImGuiDataType   PreviewDataType;
+    ImVector<ImU8>  FrameData;                                  // bytes of the visible rows, fetched once per frame
+    ImVector<ImU32> FrameColors;                                // highlight colors of the visible rows, computed once per frame
+    size_t          FrameStart;
+    std::vector<DecodedCell> FrameDecoded;                      // decoded cells of the visible rows, in address order
 
     MemoryEditor()
     {
@@ -135,6 +147,7 @@ struct MemoryEditor
         HighlightFn = NULL;
         HoverFn = NULL;
         DecodeFn = NULL;
+        DecodeLookahead = 0;
 
         // State/Internals
         ContentsWidthChanged = false;
@@ -147,6 +160,7 @@ struct MemoryEditor
         HighlightMin = HighlightMax = (size_t)-1;
         PreviewEndianess = 0;
         PreviewDataType = ImGuiDataType_S32;
+        FrameStart = 0;
     }
 
     void GotoAddrAndHighlight(size_t addr_min, size_t addr_max)
@@ -165,6 +179,77 @@ struct MemoryEditor
         DataPreviewAddrEndOld = addr_max;
     }
 
+    void FetchFrame(ImU8* mem_data, size_t start, size_t size)
+    {
+        FrameStart = start;
+        FrameData.resize((int)size);
+        FrameColors.resize((int)size);
+
+        if (size == 0)
+            return;
+
+        if (ReadFn)
+            ReadFn(mem_data, start, FrameData.Data, size);
+        else
+            memcpy(FrameData.Data, mem_data + start, size);
+
+        memset(FrameColors.Data, 0x00, size * sizeof(ImU32));
+        if (HighlightFn)
+            HighlightFn(mem_data, start, FrameColors.Data, size);
+    }
+
+    void DecodeFrame(ImU8* mem_data, size_t mem_size, int line_start, int line_end)
+    {
+        FrameDecoded.clear();
+
+        if (!OptShowAdvancedDecoding || !DecodeFn)
+            return;
+
+        for (int line_i = line_start; line_i < line_end; line_i++)
+        {
+            size_t addr = (size_t)(line_i * Cols);
+            for (int n = 0; n < Cols && addr < mem_size;)
+            {
+                DecodeData decoded = DecodeFn(mem_data, addr, FrameData.Data + (addr - FrameStart), FrameStart + FrameData.Size - addr);
+                float width = ImGui::CalcTextSize(decoded.data.c_str()).x + 1;
+                size_t advance = decoded.advance;
+
+                FrameDecoded.push_back({ addr, std::move(decoded), width });
+
+                if (addr <= 1) {
+                    n++;
+                    addr++;
+                } else {
+                    n += advance;
+                    addr += advance;
+                }
+            }
+        }
+    }
+
+    bool IsInFrame(size_t addr) const
+    {
+        return addr >= FrameStart && addr < FrameStart + FrameData.Size;
+    }
+
+    ImU8 GetFrameByte(const ImU8* mem_data, size_t addr)
+    {
+        if (IsInFrame(addr))
+            return FrameData[(int)(addr - FrameStart)];
+
+        ImU8 b = 0x00;
+        if (ReadFn)
+            ReadFn(mem_data, addr, &b, 1);
+        else
+            b = mem_data[addr];
+        return b;
+    }
+
+    ImU32 GetFrameColor(size_t addr) const
+    {
+        return IsInFrame(addr) ? FrameColors[(int)(addr - FrameStart)] : 0;
+    }
+
     struct Sizes
     {
         int     AddrDigitsCount;
@@ -296,6 +381,11 @@ struct MemoryEditor
         const size_t visible_end_addr = clipper.DisplayEnd * Cols;
         const size_t visible_count = visible_end_addr - visible_start_addr;
 
+        // Read and color all visible rows at once instead of querying every byte individually
+        FetchFrame(mem_data, std::min(visible_start_addr, mem_size), std::min(visible_end_addr + (OptShowAdvancedDecoding && DecodeFn ? DecodeLookahead : 0), mem_size) - std::min(visible_start_addr, mem_size));
+        DecodeFrame(mem_data, mem_size, clipper.DisplayStart, clipper.DisplayEnd);
+        size_t decoded_index = 0;
+
         bool data_next = false;
 
         if (DataEditingAddr >= mem_size)
@@ -384,8 +474,9 @@ struct MemoryEditor
                 ImGui::SameLine(byte_pos_x);
 
                 // Draw highlight
+                const ImU32 user_color = GetFrameColor(addr);
                 bool is_highlight_from_user_range = (addr >= HighlightMin && addr < HighlightMax);
-                bool is_highlight_from_user_func = (HighlightFn && HighlightFn(mem_data, addr, false));
+                bool is_highlight_from_user_func = (user_color != 0);
                 bool is_highlight_from_preview = (addr >= DataPreviewAddr && addr <= DataPreviewAddrEnd) || (addr >= DataPreviewAddrEnd && addr <= DataPreviewAddr);
                 if (is_highlight_from_user_range || is_highlight_from_user_func || is_highlight_from_preview)
                 {
@@ -393,7 +484,7 @@ struct MemoryEditor
                     float highlight_width = s.GlyphWidth * 2;
                     bool is_next_byte_highlighted = (addr + 1 < mem_size) &&
                                                     ((HighlightMax != (size_t)-1 && addr + 1 < HighlightMax) ||
-                                                    (HighlightFn && HighlightFn(mem_data, addr + 1, true)) ||
+                                                    (is_highlight_from_user_func && GetFrameColor(addr + 1) == user_color) ||
                                                     ((addr + 1) >= DataPreviewAddr && (addr + 1) <= DataPreviewAddrEnd) || ((addr + 1) >= DataPreviewAddrEnd && (addr + 1) <= DataPreviewAddr));
                     if (is_next_byte_highlighted)
                     {
@@ -402,9 +493,9 @@ struct MemoryEditor
                             highlight_width += s.SpacingBetweenMidCols;
                     }
 
-                    ImU32 color = HighlightColor;
+                    ImU32 color = is_highlight_from_user_func ? user_color : HighlightColor;
                     if ((is_highlight_from_user_range + is_highlight_from_user_func + is_highlight_from_preview) > 1)
-                        color = (ImAlphaBlendColors(HighlightColor, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
+                        color = (ImAlphaBlendColors(color, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
 
                     draw_list->AddRectFilled(pos, ImVec2(pos.x + highlight_width, pos.y + s.LineHeight), color);
                 }
@@ -419,7 +510,7 @@ struct MemoryEditor
                         ImGui::SetKeyboardFocusHere();
                         ImGui::CaptureKeyboardFromApp(true);
                         sprintf(AddrInputBuf, format_data, s.AddrDigitsCount, base_display_addr + addr);
-                        sprintf(DataInputBuf, format_byte, ReadFn ? ReadFn(mem_data, addr) : mem_data[addr]);
+                        sprintf(DataInputBuf, format_byte, GetFrameByte(mem_data, addr));
                     }
                     ImGui::PushItemWidth(s.GlyphWidth * 2);
                     struct UserData
@@ -446,7 +537,7 @@ struct MemoryEditor
                     };
                     UserData user_data;
                     user_data.CursorPos = -1;
-                    sprintf(user_data.CurrentBufOverwrite, format_byte, ReadFn ? ReadFn(mem_data, addr) : mem_data[addr]);
+                    sprintf(user_data.CurrentBufOverwrite, format_byte, GetFrameByte(mem_data, addr));
                     ImGuiInputTextFlags flags = ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll | ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_AlwaysInsertMode | ImGuiInputTextFlags_CallbackAlways;
                     if (ImGui::InputText("##data", DataInputBuf, 32, flags, UserData::Callback, &user_data))
                         data_write = data_next = true;
@@ -465,13 +556,16 @@ struct MemoryEditor
                             WriteFn(mem_data, addr, (ImU8)data_input_value);
                         else
                             mem_data[addr] = (ImU8)data_input_value;
+
+                        if (IsInFrame(addr))
+                            FrameData[(int)(addr - FrameStart)] = (ImU8)data_input_value;
                     }
                     ImGui::PopID();
                 }
                 else
                 {
                     // NB: The trailing space is not visible but ensure there's no gap that the mouse cannot click on.
-                    ImU8 b = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+                    ImU8 b = GetFrameByte(mem_data, addr);
 
                     if (OptShowHexII)
                     {
@@ -533,19 +627,20 @@ struct MemoryEditor
                         draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), ImGui::GetColorU32(ImGuiCol_FrameBg));
                         draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), ImGui::GetColorU32(ImGuiCol_TextSelectedBg));
                     }
-                    unsigned char c = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+                    unsigned char c = GetFrameByte(mem_data, addr);
                     char display_c = (c < 32 || c >= 128) ? '.' : c;
                     draw_list->AddText(pos, (display_c == c) ? color_text : color_disabled, &display_c, &display_c + 1);
 
                     // Draw highlight
+                    const ImU32 user_color = GetFrameColor(addr);
                     bool is_highlight_from_user_range = (addr >= HighlightMin && addr < HighlightMax);
-                    bool is_highlight_from_user_func = (HighlightFn && HighlightFn(mem_data, addr, false));
+                    bool is_highlight_from_user_func = (user_color != 0);
                     bool is_highlight_from_preview = (addr >= DataPreviewAddr && addr <= DataPreviewAddrEnd) || (addr >= DataPreviewAddrEnd && addr <= DataPreviewAddr);
                     if (is_highlight_from_user_range || is_highlight_from_user_func || is_highlight_from_preview)
                     {
-                        ImU32 color = HighlightColor;
+                        ImU32 color = is_highlight_from_user_func ? user_color : HighlightColor;
                         if ((is_highlight_from_user_range + is_highlight_from_user_func + is_highlight_from_preview) > 1)
-                            color = (ImAlphaBlendColors(HighlightColor, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
+                            color = (ImAlphaBlendColors(color, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
 
                         draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), color);
                     }
@@ -594,12 +689,12 @@ struct MemoryEditor
 
                 ImGui::PopID();
 
-                for (int n = 0; n < Cols && addr < mem_size;)
+                const size_t line_end_addr = addr + Cols;
+                for (; decoded_index < FrameDecoded.size() && FrameDecoded[decoded_index].addr < line_end_addr; decoded_index++)
                 {
-                    auto decodedData = DecodeFn(mem_data, addr);
-
-                    auto displayData = decodedData.data;
-                    auto glyphWidth = ImGui::CalcTextSize(displayData.c_str()).x + 1;
+                    const auto &[cell_addr, decodedData, glyphWidth] = FrameDecoded[decoded_index];
+                    const auto &displayData = decodedData.data;
+                    addr = cell_addr;
 
                     if (addr == DataEditingAddr)
                     {
@@ -610,20 +705,21 @@ struct MemoryEditor
                     draw_list->AddText(pos, decodedData.color, displayData.c_str(), displayData.c_str() + displayData.length());
 
                     // Draw highlight
+                    const ImU32 user_color = GetFrameColor(addr);
                     bool is_highlight_from_user_range = (addr >= HighlightMin && addr < HighlightMax);
-                    bool is_highlight_from_user_func = (HighlightFn && HighlightFn(mem_data, addr, false));
+                    bool is_highlight_from_user_func = (user_color != 0);
                     bool is_highlight_from_preview = (addr >= DataPreviewAddr && addr <= DataPreviewAddrEnd) || (addr >= DataPreviewAddrEnd && addr <= DataPreviewAddr);
                     if (is_highlight_from_user_range || is_highlight_from_user_func || is_highlight_from_preview)
                     {
-                        ImU32 color = HighlightColor;
+                        ImU32 color = is_highlight_from_user_func ? user_color : HighlightColor;
                         if ((is_highlight_from_user_range + is_highlight_from_user_func + is_highlight_from_preview) > 1)
-                            color = (ImAlphaBlendColors(HighlightColor, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
+                            color = (ImAlphaBlendColors(color, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
 
                         draw_list->AddRectFilled(pos, ImVec2(pos.x + glyphWidth, pos.y + s.LineHeight), color);
                     }
 
 
-                    ImGui::PushID(line_i * Cols + n);
+                    ImGui::PushID((int)addr);
                     ImGui::SameLine();
                     ImGui::Dummy(ImVec2(glyphWidth, s.LineHeight));
 
@@ -645,14 +741,6 @@ struct MemoryEditor
                     }
 
                     pos.x += glyphWidth;
-
-                    if (addr <= 1) {
-                        n++;
-                        addr++;
-                    } else {
-                        n += decodedData.advance;
-                        addr += decodedData.advance;
-                    }
                 }
             }
         }
@@ -2,19 +2,15 @@
 
 #include <hex.hpp>
 
-#include <map>
+#include <array>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
 namespace hex {
 
-    template<typename T>
-    struct SizeSorter {
-        bool operator() (const T& lhs, const T& rhs) const {
-            return lhs.size() < rhs.size();
-        }
-    };
-
     class EncodingFile {
     public:
         enum class Type {
@@ -25,13 +21,24 @@ namespace hex {
         EncodingFile() = default;
         EncodingFile(Type type, const std::string &path);
 
-        [[nodiscard]] std::pair<std::string_view, size_t> getEncodingFor(const std::vector<u8> &buffer) const;
+        /* Returns the longest sequence at the start of buffer that has a mapping, and its length in bytes */
+        [[nodiscard]] std::pair<std::string_view, size_t> getEncodingFor(std::span<const u8> buffer) const;
         [[nodiscard]] size_t getLongestSequence() const { return this->m_longestSequence; }
 
     private:
         void parseThingyFile(std::ifstream &content);
+        void addMapping(const std::vector<u8> &from, const std::string &to);
+
+        constexpr static u32 NoEntry = 0;
+
+        /* Byte-wise trie over all mapped sequences. Index 0 is the root which is never the child of another node, so it doubles as the "no child" marker */
+        struct TrieNode {
+            std::array<u32, 0x100> children = { NoEntry };
+            std::optional<u32> value;
+        };
 
-        std::map<u32, std::map<std::vector<u8>, std::string>> m_mapping;
+        std::vector<TrieNode> m_trie = { TrieNode() };
+        std::vector<std::string> m_values;
         size_t m_longestSequence = 0;
     };
 
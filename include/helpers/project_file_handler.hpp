@@ -91,6 +91,16 @@ namespace hex {
             ProjectFile::s_dataProcessorContent = json;
         }
 
+
+        [[nodiscard]] static const std::string& getStrings() {
+            return ProjectFile::s_strings;
+        }
+
+        static void setStrings(const std::string &json) {
+            markDirty();
+            ProjectFile::s_strings = json;
+        }
+
     private:
         static inline std::string s_currProjectFilePath;
         static inline bool s_hasUnsavedChanged = false;
@@ -100,6 +110,7 @@ namespace hex {
         static inline Patches s_patches;
         static inline std::list<ImHexApi::Bookmarks::Entry> s_bookmarks;
         static inline std::string s_dataProcessorContent;
+        static inline std::string s_strings;
     };
 
 }
\ No newline at end of file
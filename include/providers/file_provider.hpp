@@ -2,7 +2,14 @@
 
 #include <hex/providers/provider.hpp>
 
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
+#include <thread>
 
 #include <sys/stat.h>
 
@@ -26,8 +33,11 @@ namespace hex::prv {
         bool isWritable() override;
         bool isResizable() override;
         bool isSavable() override;
+        [[nodiscard]] bool isThreadSafe() override;
 
         void read(u64 offset, void *buffer, size_t size, bool overlays) override;
+        [[nodiscard]] std::future<void> readAsync(std::vector<ReadRequest> requests, bool overlays) override;
+        [[nodiscard]] std::optional<MappedSpan> tryGetSpan(u64 offset, size_t size) override;
         void write(u64 offset, const void *buffer, size_t size) override;
         void resize(ssize_t newSize) override;
 
@@ -36,11 +46,27 @@ namespace hex::prv {
         size_t getActualSize() override;
 
         void save() override;
-        void saveAs(const std::string &path) override;
+        void saveAs(const std::string &path, const DataSnapshot &snapshot, const ProgressCallback &progress) override;
 
         std::vector<std::pair<std::string, std::string>> getDataInformation() override;
 
     private:
+        /* The file is mapped in aligned windows on demand so only a bounded part of it is ever mapped */
+        constexpr static size_t WindowSize = 0x100'0000;
+        constexpr static size_t MaxMappedWindows = 16;
+
+        struct MappedWindow {
+            u64 offset;
+            size_t size;
+            std::shared_ptr<u8> data;
+        };
+
+        struct PrefetchJob {
+            std::vector<ReadRequest> requests;
+            bool overlays;
+            std::promise<void> done;
+        };
+
         #if defined(OS_WINDOWS)
         HANDLE m_file = INVALID_HANDLE_VALUE;
         HANDLE m_mapping = INVALID_HANDLE_VALUE;
@@ -49,9 +75,19 @@ namespace hex::prv {
         #endif
 
         std::string m_path;
-        void *m_mappedFile = nullptr;
         size_t m_fileSize = 0;
 
+        std::list<MappedWindow> m_mappedWindows;
+        std::optional<u64> m_lastWindowOffset;
+        std::mutex m_mappingMutex;
+
+        /* A single worker serves all readAsync calls so chunked reads don't spawn a thread per chunk */
+        std::thread m_prefetchThread;
+        std::deque<PrefetchJob> m_prefetchQueue;
+        std::mutex m_prefetchMutex;
+        std::condition_variable m_prefetchSignal;
+        bool m_stopPrefetching = false;
+
         bool m_fileStatsValid = false;
         struct stat m_fileStats = { 0 };
 
@@ -59,6 +95,11 @@ namespace hex::prv {
 
         void open();
         void close();
+
+        u8* getMappedData(u64 offset, size_t &available);
+        void unmapAllWindows();
+
+        void prefetchWorker();
     };
 
 }
\ No newline at end of file
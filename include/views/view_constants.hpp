@@ -1,8 +1,10 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/helpers/search.hpp>
 
 #include <cstdio>
+#include <optional>
 #include <string>
 
 namespace hex {
@@ -18,6 +20,9 @@ namespace hex {
         std::string category;
         ConstantType type;
         std::string value;
+
+        u64 occurrences = 0;
+        std::optional<u64> firstOccurrence;
     };
 
     class ViewConstants : public View {
@@ -28,12 +33,26 @@ namespace hex {
         void drawContent() override;
         void drawMenu() override;
 
+        bool needsRedraw() override { return this->m_search.isRunning() || (this->m_searchResultsPending && this->shouldProcess()); }
+
     private:
+        struct Occurrences {
+            u64 count;
+            u64 firstAddress;
+        };
+
         void reloadConstants();
+        void searchConstants();
+        void applySearchResults();
 
         std::vector<Constant> m_constants;
         std::vector<size_t> m_filterIndices;
         std::string m_filter;
+
+        std::vector<std::vector<u8>> m_searchSequences;
+        std::vector<Occurrences> m_searchOccurrences;
+        bool m_searchResultsPending = false;
+        search::SearchTask m_search;
     };
 
 }
\ No newline at end of file
@@ -27,6 +27,7 @@ namespace hex {
         ~ViewDisassembler() override;
 
         void drawContent() override;
+        bool needsRedraw() override { return this->m_disassembling; }
         void drawMenu() override;
 
     private:
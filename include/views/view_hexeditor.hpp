@@ -1,27 +1,29 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/helpers/search.hpp>
 #include "helpers/encoding_file.hpp"
 
 #include <imgui_memory_editor.h>
 
+#include <atomic>
 #include <list>
 #include <tuple>
 #include <random>
+#include <thread>
 #include <vector>
 
 namespace hex {
 
     namespace prv { class Provider; }
 
-    using SearchFunction = std::vector<std::pair<u64, u64>> (*)(prv::Provider* &provider, std::string string);
-
     class ViewHexEditor : public View {
     public:
         ViewHexEditor();
         ~ViewHexEditor() override;
 
         void drawContent() override;
+        bool needsRedraw() override { return this->m_saving || this->m_stringSearch.isRunning() || this->m_hexSearch.isRunning() || (this->m_selectFirstSearchResult && this->shouldProcess()); }
         void drawAlwaysVisible() override;
         void drawMenu() override;
         bool handleShortcut(bool keys[512], bool ctrl, bool shift, bool alt) override;
@@ -29,16 +31,32 @@ namespace hex {
     private:
         MemoryEditor m_memoryEditor;
 
-        std::map<u64, u32> m_highlightedBytes;
+        struct HighlightRun {
+            u64 address;
+            size_t size;
+            u32 color;
+
+            [[nodiscard]] u64 end() const { return this->address + this->size; }
+        };
+
+        /* Sorted, non-overlapping colored intervals. The hex view only ever looks up the ones overlapping the visible rows */
+        std::vector<HighlightRun> m_patternHighlights;
+        std::vector<HighlightRun> m_highlights;
+
+        using SearchFunction = void (ViewHexEditor::*)(search::SearchTask &task, const std::string &query);
 
         std::vector<char> m_searchStringBuffer;
         std::vector<char> m_searchHexBuffer;
         SearchFunction m_searchFunction = nullptr;
-        std::vector<std::pair<u64, u64>> *m_lastSearchBuffer;
+        search::TextEncoding m_searchEncoding = search::TextEncoding::UTF8;
+        bool m_searchIgnoreCase = false;
+        bool m_searchRegex = false;
+        bool m_searchInvalid = false;
+        search::SearchTask *m_currSearch = nullptr;
 
-        s64 m_lastSearchIndex = 0;
-        std::vector<std::pair<u64, u64>> m_lastStringSearch;
-        std::vector<std::pair<u64, u64>> m_lastHexSearch;
+        bool m_selectFirstSearchResult = false;
+        search::SearchTask m_stringSearch;
+        search::SearchTask m_hexSearch;
 
         s64 m_gotoAddress = 0;
 
@@ -52,13 +70,29 @@ namespace hex {
 
         hex::EncodingFile m_currEncodingFile;
         u8 m_highlightAlpha = 0x80;
+        size_t m_undoMemoryLimit = 0x1000'0000;
+
+        std::atomic<bool> m_saving = false;
+        std::atomic<bool> m_cancelSaving = false;
+        std::atomic<float> m_saveProgress = 0;
+        std::thread m_saveThread;
+
+        [[nodiscard]] Region getSelection() const;
+        void rebuildHighlights();
+        static void appendHighlightRun(std::vector<HighlightRun> &runs, u64 from, u64 to, u32 color);
+        static std::vector<HighlightRun> flattenHighlightRuns(const std::vector<HighlightRun> &runs, bool newestOnTop);
 
         void drawSearchPopup();
+        void findString(search::SearchTask &task, const std::string &string);
+        void findHex(search::SearchTask &task, const std::string &string);
         void drawGotoPopup();
         void drawEditPopup();
 
         bool createFile(const std::string &path);
         void openFile(const std::string &path);
+        void cancelSearches();
+        void cancelSaving();
+        void saveFileAs(const std::string &path);
         bool saveToFile(const std::string &path, const std::vector<u8>& data);
         bool loadFromFile(const std::string &path, std::vector<u8>& data);
 
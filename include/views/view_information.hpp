@@ -1,10 +1,13 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/helpers/byte_analyzer.hpp>
 
 #include <array>
+#include <atomic>
 #include <cstdio>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace hex {
@@ -17,6 +20,7 @@ namespace hex {
         ~ViewInformation() override;
 
         void drawContent() override;
+        bool needsRedraw() override { return this->m_analyzing; }
         void drawMenu() override;
 
     private:
@@ -31,12 +35,19 @@ namespace hex {
         std::array<ImU64, 256> m_valueCounts = { 0 };
         bool m_analyzing = false;
 
+        ByteAnalyzer m_analyzer;
+        std::thread m_magicThread;
+        std::atomic<bool> m_magicDone = false;
+        std::string m_pendingFileDescription, m_pendingMimeType;
+
         std::pair<u64, u64> m_analyzedRegion = { 0, 0 };
 
         std::string m_fileDescription;
         std::string m_mimeType;
 
         void analyze();
+        void finishAnalysis();
+        void clearAnalysis();
     };
 
 }
\ No newline at end of file
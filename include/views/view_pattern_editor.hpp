@@ -24,6 +24,7 @@ namespace hex {
         void drawMenu() override;
         void drawAlwaysVisible() override;
         void drawContent() override;
+        bool needsRedraw() override { return this->m_evaluatorRunning; }
 
     private:
         pl::PatternLanguage *m_patternLanguageRuntime;
@@ -1,40 +1,79 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/helpers/file.hpp>
+#include <hex/helpers/string_extractor.hpp>
+#include <hex/helpers/string_index.hpp>
 
+#include <array>
+#include <atomic>
 #include <cstdio>
+#include <optional>
 #include <string>
+#include <thread>
 
 namespace hex {
 
     namespace prv { class Provider; }
 
-    struct FoundString {
-        u64 offset;
-        size_t size;
-    };
-
     class ViewStrings : public View {
     public:
         explicit ViewStrings();
         ~ViewStrings() override;
 
         void drawContent() override;
+        bool needsRedraw() override;
         void drawMenu() override;
 
     private:
-        bool m_searching = false;
+        enum class SortColumn { Offset, Size, Encoding, String };
+
+        struct CachedStrings {
+            u64 hash;
+            std::vector<FoundString> strings;
+            StringIndex texts;
+        };
+
+        StringExtractor m_extractor;
 
         std::vector<FoundString> m_foundStrings;
+        StringIndex m_strings;
         std::vector<size_t> m_filterIndices;
         int m_minimumLength = 5;
-        std::string m_filter;
+        std::array<bool, 6> m_encodings = { true, true, true, false, false, false };
+        std::string m_filter, m_appliedFilter;
+        bool m_sortNeeded = false;
+
+        std::thread m_sortThread;
+        std::atomic<bool> m_sorting = false;
+        std::vector<size_t> m_sortedIndices;
+        u32 m_filterGeneration = 0, m_sortGeneration = 0;
+
+        std::optional<CachedStrings> m_cachedStrings;
+        bool m_verifyingCache = false;
+
+        std::optional<File> m_exportFile;
+        bool m_exportJson = false;
+        size_t m_exportedCount = 0;
 
         std::string m_selectedString;
         std::string m_demangledName;
 
         void searchStrings();
-        void createStringContextMenu(const FoundString &foundString);
+        void clearStrings();
+        void collectResults();
+        void filterStrings(size_t from);
+        void updateFilter();
+        void sortStrings(SortColumn column, bool descending);
+        void finishSorting();
+
+        void loadCache();
+        void storeCache();
+        void checkCache();
+
+        void startExport(const std::string &path);
+        void exportStrings();
+        void createStringContextMenu(std::string_view string);
     };
 
 }
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace hex {
         ~ViewYara() override;
 
         void drawContent() override;
+        bool needsRedraw() override { return this->m_matching; }
         void drawMenu() override;
 
     private:
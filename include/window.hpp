@@ -31,6 +31,8 @@ namespace hex {
         void frame();
         void frameEnd();
 
+        bool needsRedraw();
+
         void drawWelcomeScreen();
         void resetLayout();
 
@@ -52,6 +54,7 @@ namespace hex {
         std::string m_windowTitle;
 
         double m_lastFrameTime;
+        u32 m_settleFrames = 0;
 
         bool m_prevKeysDown[512];
 
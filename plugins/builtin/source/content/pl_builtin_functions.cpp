@@ -2,6 +2,7 @@
 
 #include <hex/helpers/shared_data.hpp>
 #include <hex/helpers/fmt.hpp>
+#include <hex/helpers/search.hpp>
 
 #include <hex/pattern_language/ast_node.hpp>
 #include <hex/pattern_language/log_console.hpp>
@@ -110,22 +111,37 @@ namespace hex::plugin::builtin {
                         }, AS_TYPE(ASTNodeIntegerLiteral, params[i])->getValue()));
                 }
 
-                std::vector<u8> bytes(sequence.size(), 0x00);
-                u32 occurrences = 0;
-                for (u64 offset = 0; offset < SharedData::currentProvider->getSize() - sequence.size(); offset++) {
-                    SharedData::currentProvider->read(offset, bytes.data(), bytes.size());
+                auto provider = SharedData::currentProvider;
+                const size_t size = sequence.size();
+                search::SequenceMatcher matcher(std::move(sequence));
+
+                auto scanner = [&](u64 address, std::span<const u8> data, size_t startLimit, std::vector<Region> &matches) {
+                    matcher.find(data, startLimit, [&](size_t offset) {
+                        matches.push_back({ address + offset, size });
+                    });
+                };
 
-                    if (bytes == sequence) {
+                u32 occurrences = 0;
+                std::optional<u64> foundAddress;
+                // The rest of the pattern language reads the provider directly as well, so its current state is used
+                search::scanProvider(provider, provider->takeSnapshot(), provider->getBaseAddress(), provider->getActualSize(), size, scanner, [&](std::vector<Region> &matches, u64) {
+                    for (const auto &match : matches) {
                         if (LITERAL_COMPARE(occurrenceIndex, occurrences < occurrenceIndex)) {
                             occurrences++;
                             continue;
                         }
 
-                        return new ASTNodeIntegerLiteral(offset);
+                        foundAddress = match.address;
+                        return false;
                     }
-                }
 
-                ctx.getConsole().abortEvaluation("failed to find sequence");
+                    return true;
+                });
+
+                if (!foundAddress.has_value())
+                    ctx.getConsole().abortEvaluation("failed to find sequence");
+
+                return new ASTNodeIntegerLiteral(*foundAddress);
             });
 
             /* read_unsigned(address, size) */
@@ -25,6 +25,17 @@ namespace hex::plugin::builtin {
             return false;
         });
 
+        ContentRegistry::Settings::add("hex.builtin.setting.general", "hex.builtin.setting.general.undo_memory_limit", 256, [](auto name, nlohmann::json &setting) {
+            static int limit = static_cast<int>(setting);
+
+            if (ImGui::SliderInt(name.data(), &limit, 16, 4096, "%d MiB")) {
+                setting = limit;
+                return true;
+            }
+
+            return false;
+        });
+
         /* Interface */
 
         ContentRegistry::Settings::add("hex.builtin.setting.interface", "hex.builtin.setting.interface.color", 0, [](auto name, nlohmann::json &setting) {
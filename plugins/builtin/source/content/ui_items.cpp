@@ -65,9 +65,7 @@ namespace hex::plugin::builtin {
             // Save file as
             ImGui::Disabled([&provider] {
                 if (ImGui::ToolBarButton(ICON_VS_SAVE_AS, ImGui::GetCustomColorVec4(ImGuiCustomCol_ToolbarBlue), buttonSize))
-                    hex::openFileBrowser("hex.view.hexeditor.save_as"_lang, DialogMode::Save, { }, [&provider](auto path) {
-                        provider->saveAs(path);
-                    });
+                    EventManager::post<RequestOpenWindow>("Save File As");
             }, provider == nullptr || !provider->isSavable());
 
 
@@ -164,6 +164,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.load_enconding_file", "Custom encoding Datei laden" },
                     { "hex.view.hexeditor.page", "Seite {0} / {1}" },
                     { "hex.view.hexeditor.save_as", "Speichern unter" },
+                    { "hex.view.hexeditor.saving", "Speichern..." },
                     { "hex.view.hexeditor.exit_application.title", "Applikation verlassen?" },
                     { "hex.view.hexeditor.exit_application.desc", "Es wurden ungespeicherte Änderungen an diesem Projekt vorgenommen\nBist du sicher, dass du ImHex schliessen willst?" },
                     { "hex.view.hexeditor.script.title", "Datei mit Loader Skript laden" },
@@ -200,6 +201,12 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.search.find", "Suchen" },
                         { "hex.view.hexeditor.search.find_next", "Nächstes" },
                         { "hex.view.hexeditor.search.find_prev", "Vorheriges" },
+                        { "hex.view.hexeditor.search.results", "{0} Treffer" },
+                        { "hex.view.hexeditor.search.result_limit", "Nach {0} Treffern angehalten" },
+                        { "hex.view.hexeditor.search.encoding", "Kodierung" },
+                        { "hex.view.hexeditor.search.ignore_case", "Groß-/Kleinschreibung ignorieren" },
+                        { "hex.view.hexeditor.search.regex", "Regulärer Ausdruck" },
+                        { "hex.view.hexeditor.search.invalid", "Ungültige Suchanfrage" },
                     { "hex.view.hexeditor.menu.file.goto", "Sprung" },
                         { "hex.view.hexeditor.goto.offset.absolute", "Absolut" },
                         { "hex.view.hexeditor.goto.offset.current", "Momentan" },
@@ -278,9 +285,14 @@ namespace hex::plugin::builtin {
                     { "hex.view.strings.filter", "Filter" },
                     { "hex.view.strings.extract", "Extrahieren" },
                     { "hex.view.strings.searching", "Suchen..." },
+                    { "hex.view.strings.sorting", "Sortieren..." },
+                    { "hex.view.strings.export", "Exportieren..." },
+                    { "hex.view.strings.export.error", "Exportdatei konnte nicht erstellt werden!" },
+                    { "hex.view.strings.verifying", "Gespeicherte Strings werden geprüft..." },
                     { "hex.view.strings.offset", "Offset" },
                     { "hex.view.strings.size", "Grösse" },
                     { "hex.view.strings.string", "String" },
+                    { "hex.view.strings.encoding", "Kodierung" },
                     { "hex.view.strings.demangle.title", "Demangled Namen" },
                     { "hex.view.strings.demangle.copy", "Kopieren" },
 
@@ -302,6 +314,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.constants.row.name", "Name" },
                     { "hex.view.constants.row.desc", "Beschreibung" },
                     { "hex.view.constants.row.value", "Wert" },
+                    { "hex.view.constants.row.occurrences", "Vorkommen" },
+                    { "hex.view.constants.search", "In Daten suchen" },
 
                 { "hex.view.store.name", "Content Store" },
                     { "hex.view.store.desc", "Downloade zusätzlichen Content von ImHex's online Datenbank" },
@@ -581,6 +595,7 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.setting.imhex.recent_files", "Kürzlich geöffnete Dateien" },
                 { "hex.builtin.setting.general", "Allgemein" },
                     { "hex.builtin.setting.general.show_tips", "Tipps beim start anzeigen" },
+                    { "hex.builtin.setting.general.undo_memory_limit", "Speicherlimit des Rückgängig-Verlaufs" },
                 { "hex.builtin.setting.interface", "Aussehen" },
                     { "hex.builtin.setting.interface.color", "Farbthema" },
                         { "hex.builtin.setting.interface.color.dark", "Dunkel" },
@@ -164,6 +164,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.load_enconding_file", "Load custom encoding File" },
                     { "hex.view.hexeditor.page", "Page {0} / {1}" },
                     { "hex.view.hexeditor.save_as", "Save As" },
+                    { "hex.view.hexeditor.saving", "Saving..." },
                     { "hex.view.hexeditor.exit_application.title", "Exit Application?" },
                     { "hex.view.hexeditor.exit_application.desc", "You have unsaved changes made to your Project.\nAre you sure you want to exit?" },
                     { "hex.view.hexeditor.script.title", "Load File with Loader Script" },
@@ -200,6 +201,12 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.search.find", "Find" },
                         { "hex.view.hexeditor.search.find_next", "Find next" },
                         { "hex.view.hexeditor.search.find_prev", "Find previous" },
+                        { "hex.view.hexeditor.search.results", "{0} results" },
+                        { "hex.view.hexeditor.search.result_limit", "Stopped after {0} results" },
+                        { "hex.view.hexeditor.search.encoding", "Encoding" },
+                        { "hex.view.hexeditor.search.ignore_case", "Ignore case" },
+                        { "hex.view.hexeditor.search.regex", "Regular expression" },
+                        { "hex.view.hexeditor.search.invalid", "Invalid search query" },
                     { "hex.view.hexeditor.menu.file.goto", "Goto" },
                         { "hex.view.hexeditor.goto.offset.absolute", "Absolute" },
                         { "hex.view.hexeditor.goto.offset.current", "Current" },
@@ -278,9 +285,14 @@ namespace hex::plugin::builtin {
                     { "hex.view.strings.filter", "Filter" },
                     { "hex.view.strings.extract", "Extract" },
                     { "hex.view.strings.searching", "Searching..." },
+                    { "hex.view.strings.sorting", "Sorting..." },
+                    { "hex.view.strings.export", "Export..." },
+                    { "hex.view.strings.export.error", "Failed to create export file!" },
+                    { "hex.view.strings.verifying", "Checking cached strings..." },
                     { "hex.view.strings.offset", "Offset" },
                     { "hex.view.strings.size", "Size" },
                     { "hex.view.strings.string", "String" },
+                    { "hex.view.strings.encoding", "Encoding" },
                     { "hex.view.strings.demangle.title", "Demangled name" },
                     { "hex.view.strings.demangle.copy", "Copy" },
 
@@ -302,6 +314,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.constants.row.name", "Name" },
                     { "hex.view.constants.row.desc", "Description" },
                     { "hex.view.constants.row.value", "Value" },
+                    { "hex.view.constants.row.occurrences", "Occurrences" },
+                    { "hex.view.constants.search", "Find in data" },
 
                 { "hex.view.store.name", "Content Store" },
                     { "hex.view.store.desc", "Download new content from ImHex's online database" },
@@ -582,6 +596,7 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.setting.imhex.recent_files", "Recent Files" },
                 { "hex.builtin.setting.general", "General" },
                     { "hex.builtin.setting.general.show_tips", "Show tips on startup" },
+                    { "hex.builtin.setting.general.undo_memory_limit", "Undo history memory limit" },
                 { "hex.builtin.setting.interface", "Interface" },
                     { "hex.builtin.setting.interface.color", "Color theme" },
                         { "hex.builtin.setting.interface.color.dark", "Dark" },
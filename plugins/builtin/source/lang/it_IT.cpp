@@ -164,6 +164,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.load_enconding_file", "Carica un File di codfica personalizzato" },
                     { "hex.view.hexeditor.page", "Pagina {0} / {1}" },
                     { "hex.view.hexeditor.save_as", "Salva come" },
+                    { "hex.view.hexeditor.saving", "Salvataggio..." },
                     { "hex.view.hexeditor.exit_application.title", "Uscire dall'applicazione?" },
                     { "hex.view.hexeditor.exit_application.desc", "Hai delle modifiche non salvate nel tuo progetto.\nSei sicuro di voler uscire?" },
                     { "hex.view.hexeditor.script.title", "Carica un File tramite il Caricatore di Script" },
@@ -199,6 +200,12 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.search.find", "Cerca" },
                         { "hex.view.hexeditor.search.find_next", "Cerca il prossimo" },
                         { "hex.view.hexeditor.search.find_prev", "Cerca il precedente" },
+                        { "hex.view.hexeditor.search.results", "{0} risultati" },
+                        { "hex.view.hexeditor.search.result_limit", "Interrotto dopo {0} risultati" },
+                        { "hex.view.hexeditor.search.encoding", "Codifica" },
+                        { "hex.view.hexeditor.search.ignore_case", "Ignora maiuscole/minuscole" },
+                        { "hex.view.hexeditor.search.regex", "Espressione regolare" },
+                        { "hex.view.hexeditor.search.invalid", "Query di ricerca non valida" },
                     { "hex.view.hexeditor.menu.file.goto", "Vai a" },
                         { "hex.view.hexeditor.goto.offset.absolute", "Assoluto" },
                         { "hex.view.hexeditor.goto.offset.current", "Corrente" },
@@ -277,9 +284,14 @@ namespace hex::plugin::builtin {
                     { "hex.view.strings.filter", "Filtro" },
                     { "hex.view.strings.extract", "Estrai" },
                     { "hex.view.strings.searching", "Sto cercando..." },
+                    { "hex.view.strings.sorting", "Sto ordinando..." },
+                    { "hex.view.strings.export", "Esporta..." },
+                    { "hex.view.strings.export.error", "Impossibile creare il file di esportazione!" },
+                    { "hex.view.strings.verifying", "Sto verificando le stringhe salvate..." },
                     { "hex.view.strings.offset", "Offset" },
                     { "hex.view.strings.size", "Dimensione" },
                     { "hex.view.strings.string", "Stringa" },
+                    { "hex.view.strings.encoding", "Codifica" },
                     { "hex.view.strings.demangle.title", "Nome Demangled" },
                     { "hex.view.strings.demangle.copy", "Copia" },
 
@@ -301,6 +313,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.constants.row.name", "Nome" },
                     { "hex.view.constants.row.desc", "Descrizione" },
                     { "hex.view.constants.row.value", "Valore" },
+                    { "hex.view.constants.row.occurrences", "Occorrenze" },
+                    { "hex.view.constants.search", "Cerca nei dati" },
                 { "hex.view.store.name", "Content Store" },
                 { "hex.view.store.desc", "Scarica nuovi contenuti dal database online di ImHex" },
                 { "hex.view.store.reload", "Ricarica" },
@@ -580,6 +594,7 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.setting.imhex.recent_files", "File recenti" },
                 { "hex.builtin.setting.general", "Generali" },
                     { "hex.builtin.setting.general.show_tips", "Mostra consigli all'avvio" },
+                    { "hex.builtin.setting.general.undo_memory_limit", "Limite di memoria della cronologia annulla" },
                 { "hex.builtin.setting.interface", "Interfaccia" },
                     { "hex.builtin.setting.interface.color", "Colore del Tema" },
                         { "hex.builtin.setting.interface.color.dark", "Scuro" },
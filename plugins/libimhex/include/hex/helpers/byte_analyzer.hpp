@@ -0,0 +1,83 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace hex::prv { class Provider; struct DataSnapshot; }
+
+namespace hex {
+
+    /*
+     * Counts how often every byte value occurs. Consecutive bytes go to four separate tables so runs of the same value
+     * don't make every increment wait for the previous one to finish
+     */
+    class ByteHistogram {
+    public:
+        void add(std::span<const u8> data);
+        void clear();
+
+        [[nodiscard]] std::array<u64, 0x100> getCounts() const;
+
+    private:
+        void flush();
+
+        std::array<std::array<u32, 0x100>, 4> m_tables = { };
+        std::array<u64, 0x100> m_counts = { };
+        u64 m_unflushedBytes = 0;
+    };
+
+    /*
+     * Calculates the byte value distribution of a region and the entropy of each of its blocks on a pool of worker threads.
+     * Every worker processes runs of whole blocks and keeps its own distribution which are summed up once it runs out of work
+     */
+    class ByteAnalyzer {
+    public:
+        struct Result {
+            std::array<u64, 0x100> valueCounts;
+            std::vector<float> blockEntropy;
+        };
+
+        constexpr static size_t ReadSize = 0x10'0000;
+
+        ByteAnalyzer() = default;
+        ByteAnalyzer(const ByteAnalyzer&) = delete;
+        ~ByteAnalyzer();
+
+        /* Analyzes [address, address + size) of provider in blocks of blockSize bytes. The last block may be shorter */
+        void start(prv::Provider *provider, u64 address, size_t size, u64 blockSize);
+        void cancel();
+
+        [[nodiscard]] bool isRunning() const { return this->m_activeWorkers > 0; }
+        [[nodiscard]] float getProgress() const { return float(this->m_processedBytes) / std::max<size_t>(this->m_size, 1); }
+
+        /* Returns the result once the analysis finished without being cancelled */
+        [[nodiscard]] std::optional<Result> takeResult();
+
+        /* Returns the Shannon entropy of a byte value distribution, normalized to [0, 1] */
+        [[nodiscard]] static float calculateEntropy(const std::array<u64, 0x100> &valueCounts, u64 byteCount);
+
+    private:
+        void processBlocks(prv::Provider *provider, const prv::DataSnapshot &snapshot, u64 firstBlock, u64 endBlock, std::vector<u8> &buffer, std::array<u64, 0x100> &valueCounts);
+
+        std::vector<std::thread> m_workers;
+        std::atomic<u32> m_activeWorkers = 0;
+        std::atomic<bool> m_cancelled = true;
+
+        u64 m_address = 0, m_blockSize = 0;
+        size_t m_size = 0;
+        u64 m_blockCount = 0, m_blocksPerTask = 0;
+        std::atomic<u64> m_nextTask = 0;
+        std::atomic<size_t> m_processedBytes = 0;
+
+        std::mutex m_resultMutex;
+        std::optional<Result> m_result;
+    };
+
+}
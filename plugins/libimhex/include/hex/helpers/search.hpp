@@ -0,0 +1,243 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hex::prv { class Provider; struct DataSnapshot; }
+
+namespace hex::search {
+
+    struct BytePattern {
+        std::vector<u8> bytes;
+        std::vector<u8> mask;
+    };
+
+    /*
+     * Parses hex strings like "4D 5A ?? ?? 5?". A '?' matches any value in that nibble.
+     * Whitespace separated groups with an odd number of nibbles get a leading zero added
+     */
+    std::optional<BytePattern> parseBytePattern(const std::string &string);
+
+    /*
+     * Finds every occurrence of a byte sequence, overlapping ones included.
+     * Bits cleared in mask are ignored when comparing. Candidates are located by comparing two (almost) fixed bytes of the
+     * sequence against a whole vector of positions at once and only then verified in full
+     */
+    class SequenceMatcher {
+    public:
+        SequenceMatcher() = default;
+        explicit SequenceMatcher(std::vector<u8> sequence, std::vector<u8> mask = { });
+
+        [[nodiscard]] size_t getSize() const { return this->m_sequence.size(); }
+
+        /* Calls callback(offset) in ascending order for every match in data that starts before startLimit */
+        template<typename Callback>
+        void find(std::span<const u8> data, size_t startLimit, Callback &&callback) const {
+            const size_t size = this->m_sequence.size();
+            if (size == 0 || data.size() < size)
+                return;
+
+            const size_t end = std::min(startLimit, data.size() - size + 1);
+
+            for (size_t offset = this->findNext(data, 0, end); offset < end; offset = this->findNext(data, offset + 1, end))
+                callback(offset);
+        }
+
+    private:
+        /* Returns the first match starting in [offset, end) or end if there is none */
+        [[nodiscard]] size_t findNext(std::span<const u8> data, size_t offset, size_t end) const;
+        [[nodiscard]] bool matchesAt(const u8 *data) const;
+
+        std::vector<u8> m_sequence;
+        std::vector<u8> m_mask;
+
+        std::optional<std::pair<size_t, size_t>> m_anchors;
+    };
+
+    /*
+     * Finds every occurrence of any of a set of byte sequences in a single pass using an Aho-Corasick automaton.
+     * Each byte costs one table lookup no matter how many sequences are searched for
+     */
+    class MultiSequenceMatcher {
+    public:
+        MultiSequenceMatcher() = default;
+        explicit MultiSequenceMatcher(const std::vector<std::vector<u8>> &sequences);
+
+        [[nodiscard]] size_t getMaxSize() const { return this->m_maxSize; }
+        [[nodiscard]] size_t getSize(u32 index) const { return this->m_sizes[index]; }
+
+        /* Calls callback(offset, index) for every match in data that starts before startLimit, ordered by the end of the match */
+        template<typename Callback>
+        void find(std::span<const u8> data, size_t startLimit, Callback &&callback) const {
+            if (this->m_maxSize == 0 || startLimit == 0)
+                return;
+
+            const size_t end = std::min<size_t>(data.size(), startLimit + this->m_maxSize - 1);
+
+            u32 state = 0;
+            for (size_t i = 0; i < end; i++) {
+                state = this->m_transitions[state][data[i]];
+
+                for (u32 index : this->m_outputs[state]) {
+                    const size_t offset = i + 1 - this->m_sizes[index];
+                    if (offset < startLimit)
+                        callback(offset, index);
+                }
+            }
+        }
+
+    private:
+        std::vector<std::array<u32, 0x100>> m_transitions;
+        std::vector<std::vector<u32>> m_outputs;
+        std::vector<size_t> m_sizes;
+        size_t m_maxSize = 0;
+    };
+
+    enum class TextEncoding {
+        UTF8,
+        UTF16LE,
+        UTF16BE
+    };
+
+    /* Returns the bytes text is stored as in encoding. With ignoreCase set, letters are masked so that both cases match */
+    std::optional<BytePattern> encodeText(const std::string &text, TextEncoding encoding, bool ignoreCase);
+
+    /*
+     * Finds the leftmost-longest, non-overlapping matches of a regular expression by simulating its Thompson NFA on all
+     * candidate starts at once, so the time taken is linear in the size of the data no matter the expression.
+     * Supports literals, '.', classes, the \d \w \s \xHH escapes, groups, alternations and the * + ? {n,m} quantifiers.
+     * Pattern characters are single bytes which become Latin-1 code units when searching for UTF-16 text
+     */
+    class RegexMatcher {
+    public:
+        constexpr static size_t MaxMatchSize = 0x1000;
+
+        static std::optional<RegexMatcher> compile(const std::string &pattern, TextEncoding encoding, bool ignoreCase);
+
+        /* Calls callback(offset, size) in ascending order for every non-empty match in data that starts before startLimit */
+        void find(std::span<const u8> data, size_t startLimit, const std::function<void(size_t offset, size_t size)> &callback) const;
+
+    private:
+        RegexMatcher() = default;
+
+        struct Instruction {
+            enum class Type : u8 { Class, Split, Jump, Match } type;
+            u32 first, second;
+        };
+
+        struct Thread {
+            u32 pc;
+            size_t start;
+        };
+
+        /* stack is only scratch space, it's passed in so it doesn't get reallocated for every added thread */
+        void addThread(std::vector<Thread> &threads, std::vector<u32> &marks, std::vector<u32> &stack, u32 generation, u32 pc, size_t start) const;
+
+        std::vector<Instruction> m_program;
+        std::vector<std::bitset<0x100>> m_classes;
+        std::bitset<0x100> m_firstBytes;
+
+        friend class RegexCompiler;
+    };
+
+    /* Appends the matches in data that start before startLimit to matches. address is the address of the first byte of data */
+    using Scanner = std::function<void(u64 address, std::span<const u8> data, size_t startLimit, std::vector<Region> &matches)>;
+
+    /*
+     * Runs scanner over [address, address + size) of provider's raw data with snapshot applied to it, chunk by chunk. Matches may
+     * be at most maxMatchSize bytes long to be found across chunk boundaries. onMatches(matches, scannedUntil) is called after
+     * every chunk with the new matches sorted by address and may return false to stop scanning
+     */
+    void scanProvider(prv::Provider *provider, const prv::DataSnapshot &snapshot, u64 address, size_t size, size_t maxMatchSize, const Scanner &scanner,
+                      const std::function<bool(std::vector<Region> &matches, u64 scannedUntil)> &onMatches);
+
+    /*
+     * Compact, address sorted list of search results. Each result is stored as a varint of the distance to the previous
+     * one, followed by its size only if that differs from the size of the first result. Results are grouped in pages of
+     * PageSize whose first addresses are kept uncompressed so any result can be found by decoding at most a single page
+     */
+    class SearchResults {
+    public:
+        constexpr static size_t PageSize = 0x100;
+
+        /* Results have to be appended in ascending address order */
+        void append(const Region &region);
+        void clear();
+
+        [[nodiscard]] size_t size() const { return this->m_count; }
+
+        [[nodiscard]] Region get(size_t index) const;
+        /* Returns the index of the first result that starts at or after address */
+        [[nodiscard]] size_t lowerBound(u64 address) const;
+
+    private:
+        struct Page {
+            u64 firstAddress;
+            size_t dataOffset;
+        };
+
+        /* Decodes the result at data and advances it to the next one */
+        Region decode(const u8 *&data, u64 previousAddress) const;
+
+        std::vector<u8> m_data;
+        std::vector<Page> m_pages;
+        size_t m_count = 0;
+
+        u64 m_lastAddress = 0;
+        size_t m_defaultSize = 0;
+    };
+
+    /*
+     * Scans a region of a provider for matches on a background thread.
+     * Results are published as they're found and are always sorted by address. Searching stops once MaxResults were found
+     */
+    class SearchTask {
+    public:
+        constexpr static size_t MaxResults = 10'000'000;
+
+        SearchTask() = default;
+        SearchTask(const SearchTask&) = delete;
+        ~SearchTask();
+
+        /*
+         * Starts searching [address, address + size) of provider, cancelling the previous search first. Has to be called on the
+         * thread that edits the provider, the search then runs on the data as it was at that point.
+         * Matches may be at most maxMatchSize bytes long to be found across chunk boundaries
+         */
+        void start(prv::Provider *provider, u64 address, size_t size, Scanner scanner, size_t maxMatchSize);
+        void cancel();
+        void clear();
+
+        [[nodiscard]] bool isRunning() const { return this->m_running; }
+        [[nodiscard]] float getProgress() const { return this->m_progress; }
+        [[nodiscard]] bool hasHitResultLimit() const { return this->m_hitResultLimit; }
+
+        [[nodiscard]] size_t getResultCount() const;
+        [[nodiscard]] std::optional<Region> getResult(size_t index) const;
+        /* Returns the index of the first result that starts at or after address */
+        [[nodiscard]] size_t findResult(u64 address) const;
+
+    private:
+        std::thread m_thread;
+        std::atomic<bool> m_running = false;
+        std::atomic<bool> m_cancelled = false;
+        std::atomic<float> m_progress = 0;
+        std::atomic<bool> m_hitResultLimit = false;
+
+        mutable std::mutex m_resultMutex;
+        SearchResults m_results;
+    };
+
+}
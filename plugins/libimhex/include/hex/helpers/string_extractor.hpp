@@ -0,0 +1,101 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/string_index.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hex::prv { class Provider; struct DataSnapshot; }
+
+namespace hex {
+
+    enum class StringEncoding : u8 {
+        ASCII,
+        UTF8,
+        UTF16LE,
+        UTF16BE,
+        UTF32LE,
+        UTF32BE
+    };
+
+    struct FoundString {
+        u64 offset;
+        size_t size;
+        StringEncoding encoding;
+    };
+
+    /*
+     * Extracts runs of printable characters from a provider on a pool of worker threads.
+     * The data is split into chunks and each worker owns the strings that start in its chunk. It looks back to skip a string that
+     * already started in the previous chunk and reads ahead past the end of its chunk to finish the last one. Strings that are already
+     * SplitSize bytes long at the end of their chunk are split there instead, so no worker reads further than the end of the next chunk.
+     * UTF-8 strings have to contain at least one non-ASCII character, wide strings only contain ASCII and Latin-1 characters.
+     * A hash of the scanned data is calculated along the way. Extracting with no encodings selected only calculates the hash
+     */
+    class StringExtractor {
+    public:
+        struct Settings {
+            u32 minimumLength = 5;
+            std::vector<StringEncoding> encodings = { StringEncoding::ASCII, StringEncoding::UTF8, StringEncoding::UTF16LE };
+        };
+
+        constexpr static size_t ChunkSize = 0x10'0000;
+        constexpr static size_t SplitSize = 0x1000;
+
+        StringExtractor() = default;
+        StringExtractor(const StringExtractor&) = delete;
+        ~StringExtractor();
+
+        void start(prv::Provider *provider, const Settings &settings);
+        void cancel();
+
+        [[nodiscard]] bool isRunning() const { return this->m_activeWorkers > 0; }
+        [[nodiscard]] float getProgress() const { return float(this->m_finishedChunks) / std::max<size_t>(this->m_chunkCount, 1); }
+        /* Returns the hash of the provider's data if the last extraction went through all of it without being cancelled */
+        [[nodiscard]] std::optional<u64> getContentHash();
+
+        /*
+         * Moves the strings published since the last call to the end of strings and their text, converted to UTF-8, to the end of texts.
+         * They're handed out in ascending address order
+         */
+        void takeResults(std::vector<FoundString> &strings, StringIndex &texts);
+        /* Returns true if there are strings that haven't been taken yet */
+        [[nodiscard]] bool hasPendingResults();
+
+        /* Reads a string and converts it to UTF-8 */
+        static std::string readString(prv::Provider *provider, const FoundString &string);
+        static const char* getEncodingName(StringEncoding encoding);
+
+    private:
+        void processChunk(prv::Provider *provider, const prv::DataSnapshot &snapshot, const Settings &settings, size_t chunk);
+        struct ChunkResult {
+            std::vector<FoundString> strings;
+            StringIndex texts;
+            u64 hash = 0;
+        };
+
+        void publishChunk(size_t chunk, ChunkResult &&result);
+
+        std::vector<std::thread> m_workers;
+        std::atomic<u32> m_activeWorkers = 0;
+        std::atomic<bool> m_cancelled = true;
+
+        size_t m_chunkCount = 0;
+        std::atomic<size_t> m_nextChunk = 0;
+        std::atomic<size_t> m_finishedChunks = 0;
+
+        /* Chunks finish out of order. They're held back until all chunks before them were published as well */
+        std::mutex m_resultMutex;
+        std::vector<std::optional<ChunkResult>> m_chunkResults;
+        size_t m_nextPublishedChunk = 0;
+        ChunkResult m_published;
+        u64 m_contentHash = 0;
+    };
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hex {
+
+    /*
+     * Keeps a list of strings back to back in a single buffer and answers which of them contain a substring.
+     * Needles of at least three bytes are looked up in a trigram index that maps every three byte sequence to the strings
+     * containing it, so only the strings in the shortest matching list have to be checked. The index is built on the first
+     * lookup and only extended by the strings added after that
+     */
+    class StringIndex {
+    public:
+        void add(std::string_view string);
+        void append(const StringIndex &other);
+        void clear();
+
+        [[nodiscard]] size_t size() const { return this->m_offsets.size() - 1; }
+        [[nodiscard]] std::string_view get(size_t index) const {
+            return std::string_view(this->m_data).substr(this->m_offsets[index], this->m_offsets[index + 1] - this->m_offsets[index]);
+        }
+
+        /* Appends the indices of the strings starting at from that contain needle to result, in ascending order */
+        void find(std::string_view needle, size_t from, std::vector<size_t> &result);
+        /* Removes the indices of strings that don't contain needle from indices without changing the order of the others */
+        void narrow(std::string_view needle, std::vector<size_t> &indices) const;
+
+    private:
+        constexpr static size_t TrigramSize = 3;
+
+        void updateIndex();
+
+        std::string m_data;
+        std::vector<size_t> m_offsets = { 0 };
+
+        std::unordered_map<u32, std::vector<u32>> m_trigrams;
+        size_t m_indexedCount = 0;
+    };
+
+}
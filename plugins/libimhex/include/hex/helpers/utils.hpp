@@ -4,13 +4,16 @@
 
 #include <hex/helpers/concepts.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <cctype>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -191,6 +194,43 @@ namespace hex {
         return iter != a.end();
     }
 
+    /* Sorts one part of the range per hardware thread concurrently and then merges neighbouring parts, again concurrently */
+    template<std::random_access_iterator Iter, typename Compare>
+    void parallelSort(Iter begin, Iter end, Compare compare) {
+        constexpr static size_t MinimumPartSize = 0x1'0000;
+
+        const size_t size = end - begin;
+        const size_t partCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(size / MinimumPartSize, 1));
+
+        std::vector<Iter> bounds;
+        for (size_t i = 0; i <= partCount; i++)
+            bounds.push_back(begin + size * i / partCount);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < partCount; i++)
+            threads.emplace_back([&, i] { std::sort(bounds[i], bounds[i + 1], compare); });
+
+        for (auto &thread : threads)
+            thread.join();
+
+        while (bounds.size() > 2) {
+            threads.clear();
+            for (size_t i = 0; i + 2 < bounds.size(); i += 2)
+                threads.emplace_back([&, i] { std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], compare); });
+
+            for (auto &thread : threads)
+                thread.join();
+
+            std::vector<Iter> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2)
+                merged.push_back(bounds[i]);
+            if (merged.back() != bounds.back())
+                merged.push_back(bounds.back());
+
+            bounds = std::move(merged);
+        }
+    }
+
     namespace scope_guard {
 
         #define SCOPE_GUARD ::hex::scope_guard::ScopeGuardOnExit() + [&]()
@@ -17,6 +17,7 @@
 #include <random>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace hex::pl {
 
@@ -42,6 +43,12 @@ namespace hex::pl {
 
     }
 
+    struct HighlightInterval {
+        u64 offset;
+        size_t size;
+        u32 color;
+    };
+
     class PatternData {
     public:
         PatternData(u64 offset, size_t size, u32 color = 0)
@@ -98,18 +105,11 @@ namespace hex::pl {
                 return { };
         }
 
-        virtual std::map<u64, u32> getHighlightedAddresses() {
-            if (this->isHidden()) return { };
-            if (this->m_highlightedAddresses.empty()) {
-                for (u64 i = 0; i < this->getSize(); i++)
-                    this->m_highlightedAddresses.insert({ this->getOffset() + i, this->getColor() });
-            }
-
-            return this->m_highlightedAddresses;
-        }
+        /* Appends the highlighted regions of this pattern. Where intervals overlap, the one appended first takes precedence */
+        virtual void getHighlightedIntervals(std::vector<HighlightInterval> &intervals) {
+            if (this->isHidden() || this->getSize() == 0) return;
 
-        virtual void clearHighlightedAddresses() {
-            this->m_highlightedAddresses.clear();
+            intervals.push_back({ this->getOffset(), this->getSize(), this->getColor() });
         }
 
         virtual void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) { }
@@ -240,7 +240,6 @@ namespace hex::pl {
 
     protected:
         std::endian m_endian = std::endian::native;
-        std::map<u64, u32> m_highlightedAddresses;
         bool m_hidden = false;
 
     private:
@@ -328,17 +327,11 @@ namespace hex::pl {
                 return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                auto ownAddresses = PatternData::getHighlightedAddresses();
-                auto pointedToAddresses = this->m_pointedAt->getHighlightedAddresses();
-
-                ownAddresses.merge(pointedToAddresses);
-                this->m_highlightedAddresses = ownAddresses;
-            }
-
-            return this->m_highlightedAddresses;
+        void getHighlightedIntervals(std::vector<HighlightInterval> &intervals) override {
+            PatternData::getHighlightedIntervals(intervals);
+            this->m_pointedAt->getHighlightedIntervals(intervals);
         }
+
         [[nodiscard]] std::string getFormattedName() const override {
             std::string result = this->m_pointedAt->getFormattedName() + "* : ";
             switch (this->getSize()) {
@@ -700,20 +693,9 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &entry : this->m_entries) {
-                    this->m_highlightedAddresses.merge(entry->getHighlightedAddresses());
-                }
-            }
-
-            return this->m_highlightedAddresses;
-        }
-
-        void clearHighlightedAddresses() override {
+        void getHighlightedIntervals(std::vector<HighlightInterval> &intervals) override {
             for (auto &entry : this->m_entries)
-                entry->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+                entry->getHighlightedIntervals(intervals);
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -760,7 +742,8 @@ namespace hex::pl {
         }
 
         PatternDataStaticArray(const PatternDataStaticArray &other) : PatternData(other) {
-            this->setEntries(other.getTemplate()->clone(), other.getEntryCount());
+            if (other.getTemplate() != nullptr)
+                this->setEntries(other.getTemplate()->clone(), other.getEntryCount());
         }
 
         ~PatternDataStaticArray() override {
@@ -772,7 +755,7 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            if (this->getEntryCount() == 0)
+            if (this->getEntryCount() == 0 || this->m_template == nullptr)
                 return;
 
             ImGui::TableNextRow();
@@ -812,41 +795,57 @@ namespace hex::pl {
         }
 
         std::optional<u32> highlightBytes(size_t offset) override{
-            auto entry = this->m_template->clone();
+            if (this->m_template == nullptr)
+                return { };
 
-            for (u64 address = this->getOffset(); address < this->getOffset() + this->getSize(); address += this->m_template->getSize()) {
-                entry->setOffset(address);
-                if (auto color = entry->highlightBytes(offset); color.has_value())
-                    return color.value();
-            }
+            const size_t templateSize = this->m_template->getSize();
 
-            delete entry;
+            if (templateSize == 0 || offset < this->getOffset() || offset >= this->getOffset() + templateSize * this->m_entryCount)
+                return { };
 
-            return { };
+            // All elements are laid out like the template, so translate the offset into the template's range instead of moving a copy of it to every element
+            const u64 index = (offset - this->getOffset()) / templateSize;
+            return this->m_template->highlightBytes(this->m_template->getOffset() + (offset - this->getOffset() - index * templateSize));
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                auto entry = this->m_template->clone();
+        void getHighlightedIntervals(std::vector<HighlightInterval> &intervals) override {
+            if (this->m_template == nullptr)
+                return;
 
-                for (u64 address = this->getOffset(); address < this->getOffset() + this->getSize(); address += this->m_template->getSize()) {
-                    entry->setOffset(address);
-                    entry->clearHighlightedAddresses();
-                    this->m_highlightedAddresses.merge(entry->getHighlightedAddresses());
-                }
+            const u64 templateOffset = this->m_template->getOffset();
+            const size_t templateSize = this->m_template->getSize();
 
-                delete entry;
+            if (this->m_entryCount == 0 || templateSize == 0)
+                return;
+
+            // Every element is highlighted the same way, so only the template's intervals need to be collected
+            std::vector<HighlightInterval> templateIntervals;
+            this->m_template->getHighlightedIntervals(templateIntervals);
+
+            std::vector<HighlightInterval> merged;
+            for (const auto &interval : templateIntervals) {
+                if (!merged.empty() && merged.back().offset + merged.back().size == interval.offset && merged.back().color == interval.color)
+                    merged.back().size += interval.size;
+                else
+                    merged.push_back(interval);
             }
 
-            return this->m_highlightedAddresses;
-        }
+            // Elements covered entirely by a single color turn into one interval spanning the whole array
+            if (merged.size() == 1 && merged[0].offset == templateOffset && merged[0].size == templateSize) {
+                intervals.push_back({ this->getOffset(), templateSize * this->m_entryCount, merged[0].color });
+                return;
+            }
 
-        void clearHighlightedAddresses() override {
-            this->m_template->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+            for (u64 index = 0; index < this->m_entryCount; index++) {
+                for (const auto &interval : merged)
+                    intervals.push_back({ this->getOffset() + index * templateSize + (interval.offset - templateOffset), interval.size, interval.color });
+            }
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
+            if (this->m_template == nullptr)
+                return "[" + std::to_string(this->m_entryCount) + "]";
+
             return this->m_template->getTypeName() + "[" + std::to_string(this->m_entryCount) + "]";
         }
 
@@ -875,12 +874,15 @@ namespace hex::pl {
                 return false;
 
             auto &otherArray = *static_cast<const PatternDataStaticArray*>(&other);
+            if (this->m_template == nullptr || otherArray.m_template == nullptr)
+                return this->m_template == otherArray.m_template && this->m_entryCount == otherArray.m_entryCount;
+
             return *this->m_template == *otherArray.m_template && this->m_entryCount == otherArray.m_entryCount;
         }
 
     private:
-        PatternData *m_template;
-        size_t m_entryCount;
+        PatternData *m_template = nullptr;
+        size_t m_entryCount = 0;
     };
 
     class PatternDataStruct : public PatternData {
@@ -944,20 +946,9 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
-                }
-            }
-
-            return this->m_highlightedAddresses;
-        }
-
-        void clearHighlightedAddresses() override {
+        void getHighlightedIntervals(std::vector<HighlightInterval> &intervals) override {
             for (auto &member : this->m_members)
-                member->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+                member->getHighlightedIntervals(intervals);
         }
 
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
@@ -1076,20 +1067,9 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
-                }
-            }
-
-            return this->m_highlightedAddresses;
-        }
-
-        void clearHighlightedAddresses() override {
+        void getHighlightedIntervals(std::vector<HighlightInterval> &intervals) override {
             for (auto &member : this->m_members)
-                member->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+                member->getHighlightedIntervals(intervals);
         }
 
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
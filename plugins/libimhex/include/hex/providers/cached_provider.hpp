@@ -0,0 +1,93 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/concepts.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+     * LRU cache of aligned blocks in front of a provider's readRaw. Reads that miss the cache fetch a whole
+     * block, and a run of misses on consecutive blocks reads ahead several blocks in a single call.
+     */
+    class BlockCache {
+    public:
+        constexpr static size_t BlockSize = 0x1'0000;
+        constexpr static size_t ReadAheadBlocks = 4;
+        constexpr static size_t DefaultMaxBlocks = 256;
+
+        using ReadFunction = std::function<void(u64 offset, void *buffer, size_t size)>;
+
+        explicit BlockCache(size_t maxBlocks = DefaultMaxBlocks) : m_maxBlocks(maxBlocks) { }
+
+        /* Reads [offset, offset + size) of the data that spans [dataStart, dataStart + dataSize) */
+        void read(u64 offset, void *buffer, size_t size, u64 dataStart, size_t dataSize, const ReadFunction &readFunction);
+
+        void invalidate(u64 offset, size_t size);
+        void clear();
+
+    private:
+        struct Block {
+            u64 index;
+            std::vector<u8> data;
+        };
+
+        const Block& getBlock(u64 index, u64 dataStart, size_t dataSize, const ReadFunction &readFunction);
+        void insertBlock(u64 index, std::vector<u8> &&data);
+
+        size_t m_maxBlocks;
+
+        std::list<Block> m_blocks;
+        std::unordered_map<u64, std::list<Block>::iterator> m_blockLookup;
+        std::optional<u64> m_lastMissedBlock;
+
+        u64 m_dataStart = 0;
+        std::mutex m_mutex;
+    };
+
+    /*
+     * Adds a block cache to any provider: new CachedProvider<SomeProvider>(args...)
+     * Raw reads are served from the cache, raw writes, resizes and base address changes invalidate it.
+     */
+    template<hex::derived_from<Provider> Base>
+    class CachedProvider : public Base {
+    public:
+        using Base::Base;
+
+        /* The cache's lock serializes all raw reads, including the ones going through to Base */
+        [[nodiscard]] bool isThreadSafe() override { return true; }
+
+        void readRaw(u64 offset, void *buffer, size_t size) override {
+            this->m_cache.read(offset, buffer, size, this->getBaseAddress(), this->getActualSize(), [this](u64 blockOffset, void *blockBuffer, size_t blockSize) {
+                Base::readRaw(blockOffset, blockBuffer, blockSize);
+            });
+        }
+
+        void writeRaw(u64 offset, const void *buffer, size_t size) override {
+            Base::writeRaw(offset, buffer, size);
+            this->m_cache.invalidate(offset, size);
+        }
+
+        void resize(ssize_t newSize) override {
+            Base::resize(newSize);
+            this->m_cache.clear();
+        }
+
+        void setBaseAddress(u64 address) override {
+            Base::setBaseAddress(address);
+            this->m_cache.clear();
+        }
+
+    private:
+        BlockCache m_cache;
+    };
+
+}
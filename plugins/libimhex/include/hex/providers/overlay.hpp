@@ -6,19 +6,25 @@
 
 namespace hex::prv {
 
+    class Provider;
+
     class Overlay {
     public:
-        Overlay() { }
+        explicit Overlay(Provider *provider) : m_provider(provider) { }
 
-        void setAddress(u64 address) { this->m_address = address; }
+        void setAddress(u64 address);
         [[nodiscard]] u64 getAddress() const { return this->m_address; }
 
         [[nodiscard]] u64 getSize() const { return this->m_data.size(); }
-        [[nodiscard]] std::vector<u8>& getData() { return this->m_data; }
+
+        void setData(std::vector<u8> data);
+        [[nodiscard]] const std::vector<u8>& getData() const { return this->m_data; }
 
     private:
+        Provider *m_provider;
+
         u64 m_address = 0;
         std::vector<u8> m_data;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+     * Stores patched bytes as runs of (offset, bytes) extents inside a persistent treap.
+     * Nodes are immutable and shared between copies, so copying a PatchTree is O(1) and a
+     * write only re-creates the O(log n) nodes on the path to the modified extent.
+     * Extents never cross a MaxExtentSize boundary which bounds the cost of editing inside of one.
+     */
+    class PatchTree {
+    public:
+        constexpr static size_t MaxExtentSize = 0x1000;
+
+        PatchTree() = default;
+        explicit PatchTree(const std::map<u64, u8> &patches);
+
+        void write(u64 offset, const void *buffer, size_t size);
+        void erase(u64 offset, size_t size = 1);
+        void clear();
+
+        /* Returns the patches inside of [offset, offset + size). Extents are shared with this tree, not copied */
+        [[nodiscard]] PatchTree extract(u64 offset, size_t size) const;
+        /* Replaces all patches inside of [offset, offset + size) with the ones from patches that lie in that range */
+        void replace(u64 offset, size_t size, const PatchTree &patches);
+
+        [[nodiscard]] std::optional<u8> get(u64 address) const;
+        [[nodiscard]] bool contains(u64 address) const { return this->get(address).has_value(); }
+        /* Checks if any byte inside of [offset, offset + size) is patched */
+        [[nodiscard]] bool overlaps(u64 offset, size_t size) const;
+
+        [[nodiscard]] bool empty() const { return this->m_root == nullptr; }
+        [[nodiscard]] size_t size() const { return this->m_byteCount; }
+
+        [[nodiscard]] std::map<u64, u8> toMap() const;
+
+        /* Calls callback(address, bytes) for every extent in ascending address order */
+        template<typename Callback>
+        void forEach(Callback &&callback) const {
+            forEach(this->m_root.get(), callback);
+        }
+
+        /* Calls callback(address, bytes) for every extent overlapping [offset, offset + size), clipped to that range */
+        template<typename Callback>
+        void forEachInRange(u64 offset, size_t size, Callback &&callback) const {
+            if (size == 0) return;
+
+            forEachInRange(this->m_root.get(), offset, offset + size, callback);
+        }
+
+    private:
+        struct Node;
+        using NodePtr = std::shared_ptr<const Node>;
+
+        struct Node {
+            u64 offset;
+            std::shared_ptr<const std::vector<u8>> data;
+            NodePtr left, right;
+
+            [[nodiscard]] u64 end() const { return this->offset + this->data->size(); }
+        };
+
+        template<typename Callback>
+        static void forEach(const Node *node, Callback &callback) {
+            if (node == nullptr) return;
+
+            forEach(node->left.get(), callback);
+            callback(node->offset, std::span<const u8>(*node->data));
+            forEach(node->right.get(), callback);
+        }
+
+        template<typename Callback>
+        static void forEachInRange(const Node *node, u64 start, u64 end, Callback &callback) {
+            while (node != nullptr) {
+                if (node->offset >= end) {
+                    node = node->left.get();
+                    continue;
+                }
+
+                if (node->offset > start)
+                    forEachInRange(node->left.get(), start, end, callback);
+
+                if (node->end() > start) {
+                    u64 from = std::max(node->offset, start);
+                    u64 to = std::min(node->end(), end);
+                    callback(from, std::span<const u8>(node->data->data() + (from - node->offset), to - from));
+                }
+
+                if (node->end() >= end)
+                    break;
+
+                node = node->right.get();
+            }
+        }
+
+        static NodePtr makeNode(u64 offset, std::shared_ptr<const std::vector<u8>> data, NodePtr left, NodePtr right);
+        static NodePtr withChildren(const NodePtr &node, NodePtr left, NodePtr right);
+
+        static std::pair<NodePtr, NodePtr> split(const NodePtr &node, u64 key);
+        static NodePtr merge(const NodePtr &left, const NodePtr &right);
+        static std::pair<NodePtr, NodePtr> popMin(const NodePtr &node);
+        static std::pair<NodePtr, NodePtr> popMax(const NodePtr &node);
+        static size_t countBytes(const Node *node);
+
+        void writeExtent(u64 offset, const u8 *buffer, size_t size);
+
+        NodePtr m_root;
+        size_t m_byteCount = 0;
+    };
+
+}
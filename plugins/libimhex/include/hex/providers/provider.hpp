@@ -2,19 +2,59 @@
 
 #include <hex.hpp>
 
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
 #include <map>
+#include <memory>
 #include <optional>
+#include <set>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <hex/helpers/shared_data.hpp>
+#include <hex/helpers/utils.hpp>
 #include <hex/providers/overlay.hpp>
+#include <hex/providers/patch_tree.hpp>
 
 namespace hex::prv {
 
+    struct ReadRequest {
+        u64 offset;
+        void *buffer;
+        size_t size;
+    };
+
+    /* Read-only view into memory owned by a provider. Holding on to owner keeps that memory valid */
+    struct MappedSpan {
+        std::span<const u8> bytes;
+        std::shared_ptr<const void> owner;
+    };
+
+    /*
+     * Copy of the patches and overlays a provider applies on top of its raw data. Readers on other threads take one up front
+     * so edits made in the meantime can't change the data under them. Copying is cheap since the patch tree shares its extents
+     */
+    struct DataSnapshot {
+        PatchTree patches;
+        std::vector<std::pair<u64, std::vector<u8>>> overlays;
+
+        /* Applies the snapshot to buffer, which holds the raw bytes of [offset, offset + size) */
+        void apply(u64 offset, void *buffer, size_t size) const;
+    };
+
+    /* Receives the number of bytes processed so far and the total number of bytes. Returning false cancels the operation */
+    using ProgressCallback = std::function<bool(u64 processed, u64 total)>;
+
     class Provider {
     public:
         constexpr static size_t PageSize = 0x1000'0000;
+        constexpr static size_t DefaultUndoMemoryLimit = 0x1000'0000;
 
         Provider();
         virtual ~Provider();
@@ -24,33 +64,110 @@ namespace hex::prv {
         virtual bool isWritable() = 0;
         virtual bool isResizable() = 0;
         virtual bool isSavable() = 0;
+        /* Whether readRaw may be called from several threads at once. Background tasks only read with a single thread otherwise */
+        [[nodiscard]] virtual bool isThreadSafe() { return false; }
 
         virtual void read(u64 offset, void *buffer, size_t size, bool overlays = true);
         virtual void readRelative(u64 offset, void *buffer, size_t size, bool overlays = true);
         virtual void write(u64 offset, const void *buffer, size_t size);
         virtual void writeRelative(u64 offset, const void *buffer, size_t size);
 
+        /* Fills all request buffers. The returned future becomes ready once every one of them has been read */
+        [[nodiscard]] virtual std::future<void> readAsync(std::vector<ReadRequest> requests, bool overlays = true);
+
+        /* Returns the bytes in [offset, offset + size) without copying them if the provider can, e.g. because they are mapped and unpatched */
+        [[nodiscard]] virtual std::optional<MappedSpan> tryGetSpan(u64 offset, size_t size);
+
+        /*
+         * Passes [offset, offset + size) to callback(chunkOffset, data, chunkSize) in chunks. Chunks are handed out
+         * in place when tryGetSpan allows it, otherwise the next chunk is already being read while the current one is processed.
+         * A callback returning bool can stop reading early by returning false
+         */
+        template<typename Callback>
+        void readChunked(u64 offset, size_t size, Callback &&callback, size_t chunkSize = 0x1'0000) {
+            if (size == 0)
+                return;
+
+            std::array<std::vector<u8>, 2> buffers;
+            std::optional<MappedSpan> nextSpan;
+            std::future<void> pendingRead;
+
+            auto prepareChunk = [&](u64 chunkOffset, std::vector<u8> &buffer) {
+                size_t currChunkSize = std::min<u64>(chunkSize, size - chunkOffset);
+
+                nextSpan = this->tryGetSpan(offset + chunkOffset, currChunkSize);
+                if (!nextSpan.has_value()) {
+                    buffer.resize(currChunkSize);
+                    pendingRead = this->readAsync({ ReadRequest { offset + chunkOffset, buffer.data(), buffer.size() } });
+                }
+            };
+
+            auto processChunk = [&](u64 chunkAddress, const u8 *data, size_t dataSize) -> bool {
+                if constexpr (std::is_same_v<std::invoke_result_t<Callback&, u64, const u8*, size_t>, bool>)
+                    return callback(chunkAddress, data, dataSize);
+                else {
+                    callback(chunkAddress, data, dataSize);
+                    return true;
+                }
+            };
+
+            /* The callback may stop early while the next chunk is still being read into one of the buffers */
+            ON_SCOPE_EXIT {
+                if (pendingRead.valid())
+                    pendingRead.wait();
+            };
+
+            prepareChunk(0, buffers[0]);
+            for (u64 chunkOffset = 0, chunk = 0; chunkOffset < size; chunkOffset += chunkSize, chunk++) {
+                auto span = std::move(nextSpan);
+                if (!span.has_value())
+                    pendingRead.wait();
+
+                if (chunkOffset + chunkSize < size)
+                    prepareChunk(chunkOffset + chunkSize, buffers[(chunk + 1) % 2]);
+
+                bool keepReading;
+                if (span.has_value()) {
+                    keepReading = processChunk(offset + chunkOffset, span->bytes.data(), span->bytes.size());
+                } else {
+                    auto &buffer = buffers[chunk % 2];
+                    keepReading = processChunk(offset + chunkOffset, static_cast<const u8*>(buffer.data()), buffer.size());
+                }
+
+                if (!keepReading)
+                    break;
+            }
+        }
+
         virtual void resize(ssize_t newSize);
 
         virtual void save();
-        virtual void saveAs(const std::string &path);
+        /* Writes the raw data with snapshot applied to it. Only reads the provider's raw data, so it can run on another thread while the provider is being edited */
+        virtual void saveAs(const std::string &path, const DataSnapshot &snapshot, const ProgressCallback &progress = { });
 
         virtual void readRaw(u64 offset, void *buffer, size_t size) = 0;
         virtual void writeRaw(u64 offset, const void *buffer, size_t size) = 0;
         virtual size_t getActualSize() = 0;
 
         void applyOverlays(u64 offset, void *buffer, size_t size);
+        [[nodiscard]] bool hasOverlays(u64 offset, size_t size);
 
-        std::map<u64, u8>& getPatches();
+        PatchTree& getPatches();
         void applyPatches();
 
+        /* Has to be called on the thread that edits the provider. The snapshot itself may then be used from any thread */
+        [[nodiscard]] DataSnapshot takeSnapshot();
+
         [[nodiscard]] Overlay* newOverlay();
         void deleteOverlay(Overlay *overlay);
         [[nodiscard]] const std::list<Overlay*>& getOverlays();
 
+        /* Pages only split up what the hex editor displays at once. Addresses always span the whole data linearly */
         u32 getPageCount();
         u32 getCurrentPage() const;
         void setCurrentPage(u32 page);
+        [[nodiscard]] u64 getCurrentPageOffset() const;
+        [[nodiscard]] size_t getCurrentPageSize();
 
         virtual void setBaseAddress(u64 address);
         virtual u64 getBaseAddress();
@@ -67,13 +184,50 @@ namespace hex::prv {
         bool canUndo();
         bool canRedo();
 
+        void setUndoMemoryLimit(size_t limit);
+        [[nodiscard]] size_t getUndoMemoryUsage() const;
+
     protected:
         u32 m_currPage = 0;
         u64 m_baseAddress = 0;
 
-        u32 m_patchTreeOffset = 0;
-        std::vector<std::map<u64, u8>> m_patches;
+        PatchTree m_patches;
         std::list<Overlay*> m_overlays;
+
+    private:
+        friend class Overlay;
+
+        struct OverlayEntry {
+            u64 order;
+            Overlay *overlay;
+        };
+
+        std::vector<OverlayEntry> getOverlappingOverlays(u64 offset, size_t size);
+        void updateOverlay(Overlay *overlay, u64 oldAddress, u64 oldSize);
+        void removeFromOverlayIndex(Overlay *overlay, u64 address, u64 size);
+
+        /* Overlays sorted by address. Together with the largest overlay size this bounds the range a read has to look at */
+        std::multimap<u64, OverlayEntry> m_overlayIndex;
+        std::multiset<u64> m_overlaySizes;
+        u64 m_nextOverlayOrder = 0;
+
+        struct UndoEntry {
+            u64 offset;
+            size_t size;
+            PatchTree oldPatches, newPatches;
+            std::chrono::steady_clock::time_point time;
+
+            /* The side of an entry that's currently applied shares its extents with m_patches, so only the other one is owned by the entry */
+            [[nodiscard]] size_t getMemoryUsage(bool applied) const { return sizeof(UndoEntry) + (applied ? this->oldPatches.size() : this->newPatches.size()); }
+        };
+
+        bool coalesceUndoEntry(u64 offset, size_t size, const PatchTree &oldPatches);
+        void trimUndoJournal();
+
+        std::deque<UndoEntry> m_undoJournal;
+        size_t m_undoPosition = 0;
+        size_t m_undoMemoryUsage = 0;
+        size_t m_undoMemoryLimit = DefaultUndoMemoryLimit;
     };
 
 }
\ No newline at end of file
@@ -34,6 +34,8 @@ namespace hex {
         virtual bool handleShortcut(bool keys[512], bool ctrl, bool shift, bool alt);
         virtual bool isAvailable();
         virtual bool shouldProcess() { return this->isAvailable() && this->getWindowOpenState(); }
+        /* Views whose content changes without any user input, e.g. while a background task is running, return true to keep new frames coming */
+        virtual bool needsRedraw() { return false; }
 
         static void doLater(std::function<void()> &&function);
         static std::vector<std::function<void()>>& getDeferedCalls();
@@ -124,7 +124,7 @@ namespace hex::dp {
             throw std::runtime_error("Tried setting overlay data on a node that's not the end of a chain!");
 
         this->m_overlay->setAddress(address);
-        this->m_overlay->getData() = data;
+        this->m_overlay->setData(data);
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include <hex/helpers/byte_analyzer.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+
+namespace hex {
+
+    void ByteHistogram::add(std::span<const u8> data) {
+        // A single table could receive every byte, so they're flushed before any of them could overflow
+        constexpr static u64 MaxUnflushedBytes = std::numeric_limits<u32>::max();
+
+        while (!data.empty()) {
+            const size_t size = std::min<u64>(data.size(), MaxUnflushedBytes - this->m_unflushedBytes);
+            const u8 *bytes = data.data();
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4) {
+                this->m_tables[0][bytes[i + 0]]++;
+                this->m_tables[1][bytes[i + 1]]++;
+                this->m_tables[2][bytes[i + 2]]++;
+                this->m_tables[3][bytes[i + 3]]++;
+            }
+            for (; i < size; i++)
+                this->m_tables[0][bytes[i]]++;
+
+            this->m_unflushedBytes += size;
+            if (this->m_unflushedBytes == MaxUnflushedBytes)
+                this->flush();
+
+            data = data.subspan(size);
+        }
+    }
+
+    void ByteHistogram::clear() {
+        this->m_tables = { };
+        this->m_counts = { };
+        this->m_unflushedBytes = 0;
+    }
+
+    void ByteHistogram::flush() {
+        for (auto &table : this->m_tables) {
+            for (u32 value = 0; value < table.size(); value++)
+                this->m_counts[value] += table[value];
+
+            table = { };
+        }
+
+        this->m_unflushedBytes = 0;
+    }
+
+    std::array<u64, 0x100> ByteHistogram::getCounts() const {
+        auto counts = this->m_counts;
+
+        for (const auto &table : this->m_tables) {
+            for (u32 value = 0; value < table.size(); value++)
+                counts[value] += table[value];
+        }
+
+        return counts;
+    }
+
+
+    ByteAnalyzer::~ByteAnalyzer() {
+        this->cancel();
+    }
+
+    void ByteAnalyzer::start(prv::Provider *provider, u64 address, size_t size, u64 blockSize) {
+        this->cancel();
+
+        this->m_cancelled = false;
+        this->m_address = address;
+        this->m_size = size;
+        this->m_blockSize = std::max<u64>(blockSize, 1);
+        this->m_blockCount = (size + this->m_blockSize - 1) / this->m_blockSize;
+        this->m_blocksPerTask = std::max<u64>(ReadSize / this->m_blockSize, 1);
+        this->m_nextTask = 0;
+        this->m_processedBytes = 0;
+
+        {
+            std::scoped_lock lock(this->m_resultMutex);
+            this->m_result = Result { { }, std::vector<float>(this->m_blockCount, 0.0F) };
+        }
+
+        const u64 taskCount = (this->m_blockCount + this->m_blocksPerTask - 1) / this->m_blocksPerTask;
+        const u32 workerCount = provider->isThreadSafe() ? std::clamp<u64>(std::thread::hardware_concurrency(), 1, std::max<u64>(taskCount, 1)) : 1;
+        this->m_activeWorkers = workerCount;
+
+        // Patches and overlays may be edited while the analysis runs, so the workers apply the ones present right now themselves
+        auto snapshot = std::make_shared<const prv::DataSnapshot>(provider->takeSnapshot());
+
+        for (u32 i = 0; i < workerCount; i++) {
+            this->m_workers.emplace_back([this, provider, snapshot, taskCount] {
+                std::vector<u8> buffer(std::min<u64>(ReadSize, this->m_size));
+                std::array<u64, 0x100> valueCounts = { };
+
+                for (u64 task = this->m_nextTask++; task < taskCount && !this->m_cancelled; task = this->m_nextTask++) {
+                    const u64 firstBlock = task * this->m_blocksPerTask;
+                    this->processBlocks(provider, *snapshot, firstBlock, std::min(firstBlock + this->m_blocksPerTask, this->m_blockCount), buffer, valueCounts);
+                }
+
+                {
+                    std::scoped_lock lock(this->m_resultMutex);
+
+                    for (u32 value = 0; value < valueCounts.size(); value++)
+                        this->m_result->valueCounts[value] += valueCounts[value];
+                }
+
+                this->m_activeWorkers--;
+            });
+        }
+    }
+
+    void ByteAnalyzer::cancel() {
+        this->m_cancelled = true;
+
+        for (auto &worker : this->m_workers)
+            worker.join();
+
+        this->m_workers.clear();
+    }
+
+    void ByteAnalyzer::processBlocks(prv::Provider *provider, const prv::DataSnapshot &snapshot, u64 firstBlock, u64 endBlock, std::vector<u8> &buffer, std::array<u64, 0x100> &valueCounts) {
+        const u64 start = firstBlock * this->m_blockSize;
+        const u64 end = std::min<u64>(endBlock * this->m_blockSize, this->m_size);
+
+        ByteHistogram histogram;
+        u64 block = firstBlock;
+        u64 blockStart = start, blockEnd = std::min(start + this->m_blockSize, end);
+
+        for (u64 offset = start; offset < end && !this->m_cancelled; ) {
+            const size_t readSize = std::min<u64>(buffer.size(), end - offset);
+            provider->readRaw(this->m_address + offset, buffer.data(), readSize);
+            snapshot.apply(this->m_address + offset, buffer.data(), readSize);
+
+            // Reads are split up at block boundaries. The last block only covers the bytes that are left in the region
+            for (u64 position = offset; position < offset + readSize; ) {
+                const u64 pieceEnd = std::min(blockEnd, offset + readSize);
+                histogram.add({ buffer.data() + (position - offset), size_t(pieceEnd - position) });
+                position = pieceEnd;
+
+                if (position == blockEnd) {
+                    const auto counts = histogram.getCounts();
+
+                    // Every block is written by exactly one worker so the entries don't need to be locked
+                    this->m_result->blockEntropy[block] = calculateEntropy(counts, blockEnd - blockStart);
+                    for (u32 value = 0; value < counts.size(); value++)
+                        valueCounts[value] += counts[value];
+
+                    histogram.clear();
+                    block++;
+                    blockStart = blockEnd;
+                    blockEnd = std::min(blockEnd + this->m_blockSize, end);
+                }
+            }
+
+            offset += readSize;
+            this->m_processedBytes += readSize;
+        }
+    }
+
+    std::optional<ByteAnalyzer::Result> ByteAnalyzer::takeResult() {
+        if (this->isRunning() || this->m_cancelled)
+            return std::nullopt;
+
+        std::scoped_lock lock(this->m_resultMutex);
+        return std::exchange(this->m_result, std::nullopt);
+    }
+
+    float ByteAnalyzer::calculateEntropy(const std::array<u64, 0x100> &valueCounts, u64 byteCount) {
+        if (byteCount == 0)
+            return 0.0F;
+
+        double entropy = 0;
+        for (u64 count : valueCounts) {
+            if (count == 0)
+                continue;
+
+            const double probability = double(count) / double(byteCount);
+            entropy -= probability * std::log2(probability);
+        }
+
+        return float(entropy / 8);
+    }
+
+}
@@ -63,16 +63,11 @@ namespace hex::crypt {
 
         u16 crc = init;
 
-        std::array<u8, 512> buffer = { 0 };
-
-        for (u64 bufferOffset = 0; offset < size; offset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-
-            for (size_t i = 0; i < readSize; i++) {
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            for (size_t i = 0; i < bufferSize; i++) {
                 crc = (crc >> 8) ^ table[(crc ^ u16(buffer[i])) & 0x00FF];
             }
-        }
+        });
 
         return crc;
     }
@@ -96,16 +91,11 @@ namespace hex::crypt {
         }();
 
         uint32_t c = init;
-        std::array<u8, 512> buffer = { 0 };
-
-        for (u64 bufferOffset = 0; offset < size; offset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-
-            for (size_t i = 0; i < readSize; i++) {
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            for (size_t i = 0; i < bufferSize; i++) {
                 c = table[(c ^ buffer[i]) & 0xFF] ^ (c >> 8);
             }
-        }
+        });
 
         return ~c;
     }
@@ -119,12 +109,9 @@ namespace hex::crypt {
 
         mbedtls_md5_starts(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_md5_update(&ctx, buffer.data(), readSize);
-        }
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            mbedtls_md5_update(&ctx, buffer, bufferSize);
+        });
 
         mbedtls_md5_finish(&ctx, result.data());
 
@@ -156,12 +143,9 @@ namespace hex::crypt {
 
         mbedtls_sha1_starts(&ctx);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha1_update(&ctx, buffer.data(), readSize);
-        }
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            mbedtls_sha1_update(&ctx, buffer, bufferSize);
+        });
 
         mbedtls_sha1_finish(&ctx, result.data());
 
@@ -193,12 +177,9 @@ namespace hex::crypt {
 
         mbedtls_sha256_starts(&ctx, true);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha256_update(&ctx, buffer.data(), readSize);
-        }
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            mbedtls_sha256_update(&ctx, buffer, bufferSize);
+        });
 
         mbedtls_sha256_finish(&ctx, result.data());
 
@@ -230,12 +211,9 @@ namespace hex::crypt {
 
         mbedtls_sha256_starts(&ctx, false);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha256_update(&ctx, buffer.data(), readSize);
-        }
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            mbedtls_sha256_update(&ctx, buffer, bufferSize);
+        });
 
         mbedtls_sha256_finish(&ctx, result.data());
 
@@ -267,12 +245,9 @@ namespace hex::crypt {
 
         mbedtls_sha512_starts(&ctx, true);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha512_update(&ctx, buffer.data(), readSize);
-        }
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            mbedtls_sha512_update(&ctx, buffer, bufferSize);
+        });
 
         mbedtls_sha512_finish(&ctx, result.data());
 
@@ -304,12 +279,9 @@ namespace hex::crypt {
 
         mbedtls_sha512_starts(&ctx, false);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha512_update(&ctx, buffer.data(), readSize);
-        }
+        data->readChunked(offset, size, [&](u64, const u8 *buffer, size_t bufferSize) {
+            mbedtls_sha512_update(&ctx, buffer, bufferSize);
+        });
 
         mbedtls_sha512_finish(&ctx, result.data());
 
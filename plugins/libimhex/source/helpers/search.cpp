@@ -0,0 +1,1055 @@
+#include <hex/helpers/search.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <codecvt>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <locale>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+namespace hex::search {
+
+    std::optional<BytePattern> parseBytePattern(const std::string &string) {
+        std::string nibbles, token;
+
+        auto addToken = [&] {
+            if ((token.size() % 2) == 1)
+                token = "0" + token;
+
+            nibbles += token;
+            token.clear();
+        };
+
+        for (char c : string) {
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                addToken();
+                continue;
+            }
+
+            if (!std::isxdigit(static_cast<unsigned char>(c)) && c != '?')
+                return std::nullopt;
+
+            token += c;
+        }
+        addToken();
+
+        auto parseNibble = [](char c) -> std::pair<u8, u8> {
+            if (c == '?')
+                return { 0x0, 0x0 };
+            else if (std::isdigit(static_cast<unsigned char>(c)))
+                return { u8(c - '0'), 0xF };
+            else
+                return { u8(std::tolower(c) - 'a' + 0xA), 0xF };
+        };
+
+        BytePattern pattern;
+        for (size_t i = 0; i < nibbles.size(); i += 2) {
+            auto [high, highMask] = parseNibble(nibbles[i]);
+            auto [low, lowMask] = parseNibble(nibbles[i + 1]);
+
+            pattern.bytes.push_back((high << 4) | low);
+            pattern.mask.push_back((highMask << 4) | lowMask);
+        }
+
+        return pattern;
+    }
+
+
+    SequenceMatcher::SequenceMatcher(std::vector<u8> sequence, std::vector<u8> mask) : m_sequence(std::move(sequence)), m_mask(std::move(mask)) {
+        this->m_mask.resize(this->m_sequence.size(), 0xFF);
+
+        for (size_t i = 0; i < this->m_sequence.size(); i++)
+            this->m_sequence[i] &= this->m_mask[i];
+
+        // The first and last byte that is fixed up to at most its case bit are used to find candidates, so that case insensitive text has anchors too
+        auto isAnchor = [](u8 mask) { return std::popcount(mask) >= 7; };
+        auto first = std::find_if(this->m_mask.begin(), this->m_mask.end(), isAnchor);
+        auto last = std::find_if(this->m_mask.rbegin(), this->m_mask.rend(), isAnchor);
+
+        if (first != this->m_mask.end())
+            this->m_anchors = std::make_pair<size_t, size_t>(first - this->m_mask.begin(), this->m_mask.rend() - last - 1);
+
+        auto isFixed = [](u8 mask) { return mask == 0xFF; };
+
+        if (std::all_of(this->m_mask.begin(), this->m_mask.end(), isFixed))
+            this->m_mask.clear();
+    }
+
+    bool SequenceMatcher::matchesAt(const u8 *data) const {
+        if (this->m_mask.empty())
+            return std::memcmp(data, this->m_sequence.data(), this->m_sequence.size()) == 0;
+
+        for (size_t i = 0; i < this->m_sequence.size(); i++) {
+            if ((data[i] & this->m_mask[i]) != this->m_sequence[i])
+                return false;
+        }
+
+        return true;
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+    #if defined(__GNUC__)
+        #define TARGET_AVX2 __attribute__((target("avx2")))
+
+        static bool hasAVX2() {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+    #else
+        #define TARGET_AVX2
+
+        static bool hasAVX2() { return false; }
+    #endif
+
+    /* Returns a bitmask of the positions in [offset, offset + 32) where both masked anchor bytes match */
+    TARGET_AVX2 static u32 findCandidatesAVX2(const u8 *data, size_t offset, size_t firstAnchor, size_t lastAnchor, u8 first, u8 last, u8 firstMask, u8 lastMask) {
+        const auto firstBytes = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + firstAnchor)), _mm256_set1_epi8(firstMask));
+        const auto lastBytes  = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset + lastAnchor)), _mm256_set1_epi8(lastMask));
+
+        const auto matches = _mm256_and_si256(_mm256_cmpeq_epi8(firstBytes, _mm256_set1_epi8(first)), _mm256_cmpeq_epi8(lastBytes, _mm256_set1_epi8(last)));
+
+        return _mm256_movemask_epi8(matches);
+    }
+
+    /* Returns a bitmask of the positions in [offset, offset + 16) where both masked anchor bytes match */
+    static u32 findCandidatesSSE2(const u8 *data, size_t offset, size_t firstAnchor, size_t lastAnchor, u8 first, u8 last, u8 firstMask, u8 lastMask) {
+        const auto firstBytes = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + firstAnchor)), _mm_set1_epi8(firstMask));
+        const auto lastBytes  = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + lastAnchor)), _mm_set1_epi8(lastMask));
+
+        const auto matches = _mm_and_si128(_mm_cmpeq_epi8(firstBytes, _mm_set1_epi8(first)), _mm_cmpeq_epi8(lastBytes, _mm_set1_epi8(last)));
+
+        return _mm_movemask_epi8(matches);
+    }
+
+#endif
+
+    size_t SequenceMatcher::findNext(std::span<const u8> data, size_t offset, size_t end) const {
+        const u8 *bytes = data.data();
+
+        if (!this->m_anchors.has_value()) {
+            for (; offset < end; offset++) {
+                if (this->matchesAt(bytes + offset))
+                    return offset;
+            }
+
+            return end;
+        }
+
+        const auto [firstAnchor, lastAnchor] = *this->m_anchors;
+        const u8 first = this->m_sequence[firstAnchor];
+        const u8 last = this->m_sequence[lastAnchor];
+        const u8 firstMask = this->m_mask.empty() ? 0xFF : this->m_mask[firstAnchor];
+        const u8 lastMask = this->m_mask.empty() ? 0xFF : this->m_mask[lastAnchor];
+
+        // Every position in a block is a valid match start, so all anchor loads stay inside of data
+        auto checkCandidates = [&](size_t blockOffset, u32 candidates) -> std::optional<size_t> {
+            for (; candidates != 0; candidates &= candidates - 1) {
+                const size_t candidate = blockOffset + std::countr_zero(candidates);
+
+                if (this->matchesAt(bytes + candidate))
+                    return candidate;
+            }
+
+            return std::nullopt;
+        };
+
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hasAVX2()) {
+            for (; offset + 32 <= end; offset += 32) {
+                if (auto match = checkCandidates(offset, findCandidatesAVX2(bytes, offset, firstAnchor, lastAnchor, first, last, firstMask, lastMask)); match.has_value())
+                    return *match;
+            }
+        }
+
+        for (; offset + 16 <= end; offset += 16) {
+            if (auto match = checkCandidates(offset, findCandidatesSSE2(bytes, offset, firstAnchor, lastAnchor, first, last, firstMask, lastMask)); match.has_value())
+                return *match;
+        }
+#endif
+
+        if (firstMask != 0xFF) {
+            for (; offset < end; offset++) {
+                if ((bytes[offset + firstAnchor] & firstMask) == first && (bytes[offset + lastAnchor] & lastMask) == last && this->matchesAt(bytes + offset))
+                    return offset;
+            }
+
+            return end;
+        }
+
+        while (offset < end) {
+            auto candidate = static_cast<const u8*>(std::memchr(bytes + offset + firstAnchor, first, end - offset));
+            if (candidate == nullptr)
+                break;
+
+            offset = (candidate - bytes) - firstAnchor;
+            if ((bytes[offset + lastAnchor] & lastMask) == last && this->matchesAt(bytes + offset))
+                return offset;
+
+            offset++;
+        }
+
+        return end;
+    }
+
+
+    MultiSequenceMatcher::MultiSequenceMatcher(const std::vector<std::vector<u8>> &sequences) {
+        this->m_transitions.push_back({ });
+        this->m_outputs.emplace_back();
+
+        // Build the trie of all sequences. Zero doubles as the missing transition since nothing points back to the root
+        for (u32 index = 0; index < sequences.size(); index++) {
+            const auto &sequence = sequences[index];
+            this->m_sizes.push_back(sequence.size());
+
+            if (sequence.empty())
+                continue;
+
+            u32 state = 0;
+            for (u8 byte : sequence) {
+                if (this->m_transitions[state][byte] == 0) {
+                    this->m_transitions[state][byte] = this->m_transitions.size();
+                    this->m_transitions.push_back({ });
+                    this->m_outputs.emplace_back();
+                }
+
+                state = this->m_transitions[state][byte];
+            }
+
+            this->m_outputs[state].push_back(index);
+            this->m_maxSize = std::max(this->m_maxSize, sequence.size());
+        }
+
+        // Turn the trie into a DFA by filling in the missing transitions from each state's longest proper suffix
+        std::vector<u32> fallbacks(this->m_transitions.size(), 0);
+        std::deque<u32> queue;
+
+        for (u32 next : this->m_transitions[0]) {
+            if (next != 0)
+                queue.push_back(next);
+        }
+
+        while (!queue.empty()) {
+            const u32 state = queue.front();
+            queue.pop_front();
+
+            const u32 fallback = fallbacks[state];
+            auto &fallbackOutputs = this->m_outputs[fallback];
+            this->m_outputs[state].insert(this->m_outputs[state].end(), fallbackOutputs.begin(), fallbackOutputs.end());
+
+            for (u32 byte = 0; byte < 0x100; byte++) {
+                u32 &next = this->m_transitions[state][byte];
+
+                if (next != 0) {
+                    fallbacks[next] = this->m_transitions[fallback][byte];
+                    queue.push_back(next);
+                } else {
+                    next = this->m_transitions[fallback][byte];
+                }
+            }
+        }
+    }
+
+
+    std::optional<BytePattern> encodeText(const std::string &text, TextEncoding encoding, bool ignoreCase) {
+        BytePattern pattern;
+
+        auto addUnit = [&](u8 value, u8 mask) {
+            pattern.bytes.push_back(value);
+            pattern.mask.push_back(mask);
+        };
+
+        // Letters only differ in bit 5 between their upper and lower case forms
+        auto getCaseMask = [&](char16_t unit) -> u8 {
+            return (ignoreCase && unit < 0x80 && std::isalpha(unit)) ? 0xDF : 0xFF;
+        };
+
+        if (encoding == TextEncoding::UTF8) {
+            for (char c : text)
+                addUnit(c, getCaseMask(static_cast<u8>(c)));
+
+            return pattern;
+        }
+
+        std::u16string units;
+        try {
+            units = std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>{}.from_bytes(text);
+        } catch (std::range_error &) {
+            return std::nullopt;
+        }
+
+        for (char16_t unit : units) {
+            if (encoding == TextEncoding::UTF16LE) {
+                addUnit(unit & 0xFF, getCaseMask(unit));
+                addUnit(unit >> 8, 0xFF);
+            } else {
+                addUnit(unit >> 8, 0xFF);
+                addUnit(unit & 0xFF, getCaseMask(unit));
+            }
+        }
+
+        return pattern;
+    }
+
+
+    class RegexCompiler {
+    public:
+        RegexCompiler(const std::string &pattern, TextEncoding encoding, bool ignoreCase) : m_pattern(pattern), m_encoding(encoding), m_ignoreCase(ignoreCase) { }
+
+        std::optional<RegexMatcher> compile() {
+            auto root = this->parseAlternation();
+            if (!root.has_value() || this->m_position != this->m_pattern.size())
+                return std::nullopt;
+
+            RegexMatcher matcher;
+            this->m_matcher = &matcher;
+
+            this->emit(*root);
+            this->emitInstruction(Instruction::Type::Match);
+
+            if (this->m_matcher->m_program.size() > MaxProgramSize)
+                return std::nullopt;
+
+            // Every non-empty match has to start with one of the bytes accepted by the instructions reachable from the start
+            std::vector<Thread> threads;
+            std::vector<u32> marks(matcher.m_program.size(), 0), stack;
+            matcher.addThread(threads, marks, stack, 1, 0, 0);
+            for (const auto &thread : threads) {
+                if (matcher.m_program[thread.pc].type == Instruction::Type::Class)
+                    matcher.m_firstBytes |= matcher.m_classes[matcher.m_program[thread.pc].first];
+            }
+
+            return matcher;
+        }
+
+    private:
+        using Instruction = RegexMatcher::Instruction;
+        using Thread = RegexMatcher::Thread;
+        using ByteSet = std::bitset<0x100>;
+
+        constexpr static u32 Unbounded = std::numeric_limits<u32>::max();
+        constexpr static u32 MaxRepetitions = 1000;
+        constexpr static size_t MaxProgramSize = 0x10000;
+
+        struct Node {
+            enum class Type { Empty, Class, Concat, Alternate, Repeat } type;
+
+            ByteSet set;
+            /* Negated classes and '.' also match UTF-16 code units outside of Latin-1 */
+            bool matchesWide = false;
+
+            std::vector<Node> children;
+            u32 min = 0, max = 0;
+        };
+
+        [[nodiscard]] bool atEnd() const { return this->m_position >= this->m_pattern.size(); }
+        [[nodiscard]] char peek() const { return this->m_pattern[this->m_position]; }
+
+        bool consume(char c) {
+            if (this->atEnd() || this->peek() != c)
+                return false;
+
+            this->m_position++;
+            return true;
+        }
+
+        std::optional<Node> parseAlternation() {
+            auto left = this->parseConcatenation();
+            if (!left.has_value())
+                return std::nullopt;
+
+            while (this->consume('|')) {
+                auto right = this->parseConcatenation();
+                if (!right.has_value())
+                    return std::nullopt;
+
+                left = Node { Node::Type::Alternate, { }, false, { std::move(*left), std::move(*right) } };
+            }
+
+            return left;
+        }
+
+        std::optional<Node> parseConcatenation() {
+            Node node { Node::Type::Concat };
+
+            while (!this->atEnd() && this->peek() != '|' && this->peek() != ')') {
+                auto repeat = this->parseRepeat();
+                if (!repeat.has_value())
+                    return std::nullopt;
+
+                node.children.push_back(std::move(*repeat));
+            }
+
+            return node;
+        }
+
+        std::optional<u32> parseNumber() {
+            if (this->atEnd() || !std::isdigit(static_cast<unsigned char>(this->peek())))
+                return std::nullopt;
+
+            u32 value = 0;
+            while (!this->atEnd() && std::isdigit(static_cast<unsigned char>(this->peek()))) {
+                value = value * 10 + (this->m_pattern[this->m_position++] - '0');
+                if (value > MaxRepetitions)
+                    return std::nullopt;
+            }
+
+            return value;
+        }
+
+        std::optional<Node> parseRepeat() {
+            auto atom = this->parseAtom();
+            if (!atom.has_value())
+                return std::nullopt;
+
+            while (!this->atEnd()) {
+                u32 min, max;
+
+                if (this->consume('*'))
+                    min = 0, max = Unbounded;
+                else if (this->consume('+'))
+                    min = 1, max = Unbounded;
+                else if (this->consume('?'))
+                    min = 0, max = 1;
+                else if (this->consume('{')) {
+                    auto lower = this->parseNumber();
+                    if (!lower.has_value())
+                        return std::nullopt;
+
+                    min = max = *lower;
+                    if (this->consume(',')) {
+                        auto upper = this->parseNumber();
+                        max = upper.value_or(Unbounded);
+                    }
+
+                    if (!this->consume('}') || min > max)
+                        return std::nullopt;
+                }
+                else
+                    break;
+
+                // Matches are always the longest ones so lazy quantifiers have no meaning here
+                if (!this->atEnd() && this->peek() == '?')
+                    return std::nullopt;
+
+                atom = Node { Node::Type::Repeat, { }, false, { std::move(*atom) }, min, max };
+            }
+
+            return atom;
+        }
+
+        void addCharacter(ByteSet &set, u8 c) const {
+            set.set(c);
+
+            if (this->m_ignoreCase && std::isalpha(c) && c < 0x80)
+                set.set(c ^ 0x20);
+        }
+
+        static u8 getFirst(const ByteSet &set) {
+            u32 value = 0;
+            while (!set[value])
+                value++;
+
+            return value;
+        }
+
+        static ByteSet getClassEscape(char c) {
+            ByteSet set;
+            for (u32 i = 0; i < 0x100; i++) {
+                bool isWord = std::isalnum(i) || i == '_';
+
+                switch (std::tolower(c)) {
+                    case 'd': set[i] = std::isdigit(i); break;
+                    case 'w': set[i] = i < 0x80 && isWord; break;
+                    case 's': set[i] = i < 0x80 && std::isspace(i); break;
+                }
+            }
+
+            return std::isupper(c) ? ~set : set;
+        }
+
+        /* Parses the part after a backslash. Returns the set of bytes it matches and whether it is a negated class */
+        std::optional<std::pair<ByteSet, bool>> parseEscape() {
+            if (this->atEnd())
+                return std::nullopt;
+
+            char c = this->m_pattern[this->m_position++];
+            ByteSet set;
+
+            switch (c) {
+                case 'd': case 'D': case 'w': case 'W': case 's': case 'S':
+                    return std::make_pair(getClassEscape(c), bool(std::isupper(c)));
+                case 'n': set.set('\n'); break;
+                case 'r': set.set('\r'); break;
+                case 't': set.set('\t'); break;
+                case '0': set.set(0x00); break;
+                case 'x': {
+                    if (this->m_position + 2 > this->m_pattern.size())
+                        return std::nullopt;
+
+                    auto digits = this->m_pattern.substr(this->m_position, 2);
+                    if (!std::isxdigit(static_cast<unsigned char>(digits[0])) || !std::isxdigit(static_cast<unsigned char>(digits[1])))
+                        return std::nullopt;
+
+                    set.set(std::stoul(digits, nullptr, 16));
+                    this->m_position += 2;
+                    break;
+                }
+                default:
+                    if (std::isalnum(static_cast<unsigned char>(c)))
+                        return std::nullopt;
+
+                    this->addCharacter(set, c);
+                    break;
+            }
+
+            return std::make_pair(set, false);
+        }
+
+        std::optional<Node> parseClass() {
+            ByteSet set;
+            bool negated = this->consume('^');
+            bool first = true;
+
+            while (!this->atEnd() && (this->peek() != ']' || first)) {
+                first = false;
+
+                u8 from;
+                if (this->consume('\\')) {
+                    auto escape = this->parseEscape();
+                    if (!escape.has_value())
+                        return std::nullopt;
+
+                    // Only single characters can start a range
+                    if (escape->first.count() != 1 || this->atEnd() || this->peek() != '-') {
+                        set |= escape->first;
+                        continue;
+                    }
+
+                    from = getFirst(escape->first);
+                } else {
+                    from = this->m_pattern[this->m_position++];
+                }
+
+                if (this->m_position + 1 < this->m_pattern.size() && this->peek() == '-' && this->m_pattern[this->m_position + 1] != ']') {
+                    this->m_position++;
+
+                    u8 to;
+                    if (this->consume('\\')) {
+                        auto escape = this->parseEscape();
+                        if (!escape.has_value() || escape->first.count() != 1)
+                            return std::nullopt;
+
+                        to = getFirst(escape->first);
+                    } else {
+                        to = this->m_pattern[this->m_position++];
+                    }
+
+                    if (from > to)
+                        return std::nullopt;
+
+                    for (u32 c = from; c <= to; c++)
+                        this->addCharacter(set, c);
+                } else {
+                    this->addCharacter(set, from);
+                }
+            }
+
+            if (!this->consume(']'))
+                return std::nullopt;
+
+            return Node { Node::Type::Class, negated ? ~set : set, negated };
+        }
+
+        std::optional<Node> parseAtom() {
+            if (this->atEnd())
+                return std::nullopt;
+
+            char c = this->m_pattern[this->m_position++];
+            switch (c) {
+                case '(': {
+                    if (this->consume('?') && !this->consume(':'))
+                        return std::nullopt;
+
+                    auto group = this->parseAlternation();
+                    if (!group.has_value() || !this->consume(')'))
+                        return std::nullopt;
+
+                    return group;
+                }
+                case '[':
+                    return this->parseClass();
+                case '.':
+                    return Node { Node::Type::Class, ~ByteSet().set('\n'), true };
+                case '\\': {
+                    auto escape = this->parseEscape();
+                    if (!escape.has_value())
+                        return std::nullopt;
+
+                    return Node { Node::Type::Class, escape->first, escape->second };
+                }
+                case ')': case '*': case '+': case '?': case '{': case '^': case '$':
+                    // Anchors have no meaning when searching through chunks of data
+                    return std::nullopt;
+                default: {
+                    ByteSet set;
+                    this->addCharacter(set, c);
+
+                    return Node { Node::Type::Class, set };
+                }
+            }
+        }
+
+        u32 emitInstruction(Instruction::Type type, u32 first = 0, u32 second = 0) {
+            this->m_matcher->m_program.push_back({ type, first, second });
+            return this->m_matcher->m_program.size() - 1;
+        }
+
+        void emitByteClass(const ByteSet &set) {
+            auto &classes = this->m_matcher->m_classes;
+
+            auto it = std::find(classes.begin(), classes.end(), set);
+            if (it == classes.end())
+                it = classes.insert(classes.end(), set);
+
+            this->emitInstruction(Instruction::Type::Class, it - classes.begin());
+        }
+
+        void emitCodeUnit(const ByteSet &low, const ByteSet &high) {
+            if (this->m_encoding == TextEncoding::UTF16LE) {
+                this->emitByteClass(low);
+                this->emitByteClass(high);
+            } else {
+                this->emitByteClass(high);
+                this->emitByteClass(low);
+            }
+        }
+
+        void emitClass(const Node &node) {
+            if (this->m_encoding == TextEncoding::UTF8) {
+                this->emitByteClass(node.set);
+                return;
+            }
+
+            const ByteSet zero = ByteSet().set(0x00);
+            if (!node.matchesWide) {
+                this->emitCodeUnit(node.set, zero);
+                return;
+            }
+
+            // Either a Latin-1 code unit in the set or any code unit with a non-zero high byte
+            auto split = this->emitInstruction(Instruction::Type::Split);
+            this->program()[split].first = this->program().size();
+            this->emitCodeUnit(node.set, zero);
+
+            auto jump = this->emitInstruction(Instruction::Type::Jump);
+            this->program()[split].second = this->program().size();
+            this->emitCodeUnit(ByteSet().set(), ~zero);
+
+            this->program()[jump].first = this->program().size();
+        }
+
+        void emitRepeat(const Node &node) {
+            const auto &child = node.children.front();
+
+            for (u32 i = 0; i < node.min; i++)
+                this->emit(child);
+
+            if (node.max == Unbounded) {
+                // Loop: split into the child or out of the loop, then jump back to the split
+                auto split = this->emitInstruction(Instruction::Type::Split);
+                this->program()[split].first = this->program().size();
+                this->emit(child);
+                this->emitInstruction(Instruction::Type::Jump, split);
+                this->program()[split].second = this->program().size();
+            } else {
+                std::vector<u32> splits;
+                for (u32 i = node.min; i < node.max; i++) {
+                    auto split = this->emitInstruction(Instruction::Type::Split);
+                    this->program()[split].first = this->program().size();
+                    splits.push_back(split);
+
+                    this->emit(child);
+                }
+
+                for (auto split : splits)
+                    this->program()[split].second = this->program().size();
+            }
+        }
+
+        void emit(const Node &node) {
+            // Stop growing the program once it's too large, compile() rejects it afterwards
+            if (this->program().size() > MaxProgramSize)
+                return;
+
+            switch (node.type) {
+                case Node::Type::Empty:
+                    break;
+                case Node::Type::Class:
+                    this->emitClass(node);
+                    break;
+                case Node::Type::Concat:
+                    for (const auto &child : node.children)
+                        this->emit(child);
+                    break;
+                case Node::Type::Alternate: {
+                    auto split = this->emitInstruction(Instruction::Type::Split);
+                    this->program()[split].first = this->program().size();
+                    this->emit(node.children[0]);
+
+                    auto jump = this->emitInstruction(Instruction::Type::Jump);
+                    this->program()[split].second = this->program().size();
+                    this->emit(node.children[1]);
+
+                    this->program()[jump].first = this->program().size();
+                    break;
+                }
+                case Node::Type::Repeat:
+                    this->emitRepeat(node);
+                    break;
+            }
+        }
+
+        std::vector<Instruction>& program() { return this->m_matcher->m_program; }
+
+        std::string m_pattern;
+        size_t m_position = 0;
+        TextEncoding m_encoding;
+        bool m_ignoreCase;
+
+        RegexMatcher *m_matcher = nullptr;
+    };
+
+    std::optional<RegexMatcher> RegexMatcher::compile(const std::string &pattern, TextEncoding encoding, bool ignoreCase) {
+        return RegexCompiler(pattern, encoding, ignoreCase).compile();
+    }
+
+    void RegexMatcher::addThread(std::vector<Thread> &threads, std::vector<u32> &marks, std::vector<u32> &stack, u32 generation, u32 pc, size_t start) const {
+        stack.clear();
+        stack.push_back(pc);
+
+        while (!stack.empty()) {
+            pc = stack.back();
+            stack.pop_back();
+
+            if (marks[pc] == generation)
+                continue;
+            marks[pc] = generation;
+
+            const auto &instruction = this->m_program[pc];
+            switch (instruction.type) {
+                case Instruction::Type::Jump:
+                    stack.push_back(instruction.first);
+                    break;
+                case Instruction::Type::Split:
+                    stack.push_back(instruction.second);
+                    stack.push_back(instruction.first);
+                    break;
+                default:
+                    threads.push_back({ pc, start });
+                    break;
+            }
+        }
+    }
+
+    void RegexMatcher::find(std::span<const u8> data, size_t startLimit, const std::function<void(size_t offset, size_t size)> &callback) const {
+        startLimit = std::min(startLimit, data.size());
+
+        // Thread lists are ordered by start since threads are only ever appended after all threads that started earlier
+        std::vector<Thread> current, next;
+        std::vector<u32> marks(this->m_program.size(), 0);
+        std::vector<u32> stack;
+        u32 generation = 1, currentGeneration = 1;
+
+        constexpr static size_t NoMatch = std::numeric_limits<size_t>::max();
+        size_t matchStart = NoMatch, matchEnd = 0;
+
+        size_t position = 0;
+        while (true) {
+            if (matchStart == NoMatch && position < startLimit) {
+                // Nothing is in progress so skip straight to the next byte that can start a match
+                if (current.empty()) {
+                    while (position < startLimit && !this->m_firstBytes[data[position]])
+                        position++;
+
+                    if (position == startLimit)
+                        break;
+                }
+
+                this->addThread(current, marks, stack, currentGeneration, 0, position);
+            }
+
+            const u32 nextGeneration = ++generation;
+            for (const auto &thread : current) {
+                // Once a match was found, only threads with the same or an earlier start can still replace it
+                if (matchStart != NoMatch && thread.start > matchStart)
+                    break;
+
+                const auto &instruction = this->m_program[thread.pc];
+                if (instruction.type == Instruction::Type::Match) {
+                    if (position > thread.start && (matchStart == NoMatch || thread.start < matchStart || position > matchEnd)) {
+                        matchStart = thread.start;
+                        matchEnd = position;
+                    }
+                } else if (position < data.size() && position - thread.start < MaxMatchSize && this->m_classes[instruction.first][data[position]]) {
+                    this->addThread(next, marks, stack, nextGeneration, thread.pc + 1, thread.start);
+                }
+            }
+
+            std::swap(current, next);
+            next.clear();
+            currentGeneration = nextGeneration;
+
+            if (matchStart != NoMatch && std::none_of(current.begin(), current.end(), [&](const auto &thread) { return thread.start <= matchStart; })) {
+                callback(matchStart, matchEnd - matchStart);
+
+                // Matches don't overlap so searching continues right after this one
+                current.clear();
+                currentGeneration = ++generation;
+                position = matchEnd;
+                matchStart = NoMatch;
+                continue;
+            }
+
+            if (position >= data.size() || (current.empty() && position >= startLimit))
+                break;
+
+            position++;
+        }
+    }
+
+
+    void scanProvider(prv::Provider *provider, const prv::DataSnapshot &snapshot, u64 address, size_t size, size_t maxMatchSize, const Scanner &scanner,
+                      const std::function<bool(std::vector<Region> &matches, u64 scannedUntil)> &onMatches) {
+        if (size == 0 || maxMatchSize == 0)
+            return;
+
+        // Matches that start in the last overlap bytes of a chunk are only looked for once the start of the next chunk is known
+        const size_t overlap = maxMatchSize - 1;
+        const size_t chunkSize = std::max<size_t>(0x10'0000, overlap);
+
+        std::vector<u8> buffer, carry, stitched;
+        u64 carryAddress = 0;
+        std::vector<Region> matches;
+
+        auto scan = [&](u64 dataAddress, std::span<const u8> data, size_t startLimit) {
+            scanner(dataAddress, data, startLimit, matches);
+
+            if (!std::is_sorted(matches.begin(), matches.end(), [](const auto &left, const auto &right) { return left.address < right.address; }))
+                std::sort(matches.begin(), matches.end(), [](const auto &left, const auto &right) { return left.address < right.address; });
+        };
+
+        bool stopped = false;
+        for (u64 chunkOffset = 0; chunkOffset < size && !stopped; chunkOffset += chunkSize) {
+            const u64 chunkAddress = address + chunkOffset;
+            const size_t dataSize = std::min<u64>(chunkSize, size - chunkOffset);
+
+            // Only the raw data comes from the provider, its patches and overlays may be edited while scanning
+            buffer.resize(dataSize);
+            provider->readRaw(chunkAddress, buffer.data(), dataSize);
+            snapshot.apply(chunkAddress, buffer.data(), dataSize);
+
+            const u8 *data = buffer.data();
+            if (!carry.empty()) {
+                stitched = carry;
+                stitched.insert(stitched.end(), data, data + std::min(overlap, dataSize));
+
+                scan(carryAddress, stitched, carry.size());
+            }
+
+            const size_t tailSize = std::min(overlap, dataSize);
+
+            scan(chunkAddress, { data, dataSize }, dataSize - tailSize);
+
+            carry.assign(data + (dataSize - tailSize), data + dataSize);
+            carryAddress = chunkAddress + (dataSize - tailSize);
+
+            stopped = !onMatches(matches, carryAddress);
+            matches.clear();
+        }
+
+        if (!carry.empty() && !stopped) {
+            scan(carryAddress, carry, carry.size());
+            onMatches(matches, address + size);
+        }
+    }
+
+
+    static void writeVarInt(std::vector<u8> &data, u64 value) {
+        do {
+            u8 byte = value & 0x7F;
+            value >>= 7;
+
+            data.push_back(byte | (value != 0 ? 0x80 : 0x00));
+        } while (value != 0);
+    }
+
+    static u64 readVarInt(const u8 *&data) {
+        u64 value = 0;
+
+        for (u32 shift = 0; ; shift += 7) {
+            u8 byte = *data++;
+            value |= u64(byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+    }
+
+    void SearchResults::append(const Region &region) {
+        if (this->m_count == 0)
+            this->m_defaultSize = region.size;
+
+        if ((this->m_count % PageSize) == 0) {
+            this->m_pages.push_back({ region.address, this->m_data.size() });
+            this->m_lastAddress = region.address;
+        }
+
+        // The lowest bit marks results whose size differs from the first one's
+        const bool hasSize = region.size != this->m_defaultSize;
+        writeVarInt(this->m_data, ((region.address - this->m_lastAddress) << 1) | (hasSize ? 1 : 0));
+        if (hasSize)
+            writeVarInt(this->m_data, region.size);
+
+        this->m_lastAddress = region.address;
+        this->m_count++;
+    }
+
+    void SearchResults::clear() {
+        this->m_data = { };
+        this->m_pages = { };
+        this->m_count = 0;
+        this->m_lastAddress = 0;
+        this->m_defaultSize = 0;
+    }
+
+    Region SearchResults::decode(const u8 *&data, u64 previousAddress) const {
+        const u64 value = readVarInt(data);
+
+        Region region = { previousAddress + (value >> 1), this->m_defaultSize };
+        if ((value & 1) != 0)
+            region.size = readVarInt(data);
+
+        return region;
+    }
+
+    Region SearchResults::get(size_t index) const {
+        const auto &page = this->m_pages[index / PageSize];
+        const u8 *data = this->m_data.data() + page.dataOffset;
+
+        Region region = { page.firstAddress, 0 };
+        for (size_t i = 0; i <= index % PageSize; i++)
+            region = this->decode(data, region.address);
+
+        return region;
+    }
+
+    size_t SearchResults::lowerBound(u64 address) const {
+        // Find the last page starting at or before address. Everything before it is smaller, the result is in it or starts the next one
+        auto page = std::upper_bound(this->m_pages.begin(), this->m_pages.end(), address, [](u64 address, const Page &page) { return address < page.firstAddress; });
+        if (page == this->m_pages.begin())
+            return 0;
+        --page;
+
+        const size_t pageIndex = page - this->m_pages.begin();
+        const size_t pageCount = std::min(PageSize, this->m_count - pageIndex * PageSize);
+        const u8 *data = this->m_data.data() + page->dataOffset;
+
+        Region region = { page->firstAddress, 0 };
+        for (size_t i = 0; i < pageCount; i++) {
+            region = this->decode(data, region.address);
+
+            if (region.address >= address)
+                return pageIndex * PageSize + i;
+        }
+
+        return pageIndex * PageSize + pageCount;
+    }
+
+
+    SearchTask::~SearchTask() {
+        this->cancel();
+    }
+
+    void SearchTask::start(prv::Provider *provider, u64 address, size_t size, Scanner scanner, size_t maxMatchSize) {
+        this->cancel();
+        this->clear();
+
+        this->m_cancelled = false;
+        this->m_running = true;
+        this->m_progress = 0;
+        this->m_hitResultLimit = false;
+
+        this->m_thread = std::thread([this, provider, snapshot = provider->takeSnapshot(), address, size, scanner = std::move(scanner), maxMatchSize] {
+            scanProvider(provider, snapshot, address, size, maxMatchSize, scanner, [&, this](std::vector<Region> &matches, u64 scannedUntil) {
+                if (this->m_cancelled)
+                    return false;
+
+                if (!matches.empty()) {
+                    std::scoped_lock lock(this->m_resultMutex);
+
+                    for (const auto &match : matches) {
+                        if (this->m_results.size() >= MaxResults) {
+                            this->m_hitResultLimit = true;
+                            return false;
+                        }
+
+                        this->m_results.append(match);
+                    }
+                }
+
+                this->m_progress = float(scannedUntil - address) / size;
+
+                return true;
+            });
+
+            this->m_progress = 1.0F;
+            this->m_running = false;
+        });
+    }
+
+    void SearchTask::cancel() {
+        this->m_cancelled = true;
+
+        if (this->m_thread.joinable())
+            this->m_thread.join();
+    }
+
+    void SearchTask::clear() {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        this->m_results.clear();
+        this->m_progress = 0;
+        this->m_hitResultLimit = false;
+    }
+
+    size_t SearchTask::getResultCount() const {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        return this->m_results.size();
+    }
+
+    std::optional<Region> SearchTask::getResult(size_t index) const {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        if (index >= this->m_results.size())
+            return std::nullopt;
+
+        return this->m_results.get(index);
+    }
+
+    size_t SearchTask::findResult(u64 address) const {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        return this->m_results.lowerBound(address);
+    }
+
+}
@@ -0,0 +1,476 @@
+#include <hex/helpers/string_extractor.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace hex {
+
+    namespace {
+
+        /* Bytes of the provider around a chunk as they were when the snapshot was taken. Reading past the chunk loads more data on demand */
+        class ChunkData {
+        public:
+            ChunkData(prv::Provider *provider, const prv::DataSnapshot &snapshot, u64 start, u64 end) : m_provider(provider), m_snapshot(snapshot), m_start(start) {
+                this->m_providerEnd = provider->getBaseAddress() + provider->getSize();
+                this->load(end);
+            }
+
+            /* Returns how many of the count bytes starting at address are available, loading them if needed */
+            size_t ensure(u64 address, size_t count) {
+                if (address + count > this->end() && this->end() < this->m_providerEnd)
+                    this->load(std::max(address + count, this->end() + ReadAheadSize));
+
+                return address >= this->end() ? 0 : std::min<u64>(count, this->end() - address);
+            }
+
+            const u8* at(u64 address) const { return this->m_data.data() + (address - this->m_start); }
+
+        private:
+            constexpr static size_t ReadAheadSize = 0x1'0000;
+
+            [[nodiscard]] u64 end() const { return this->m_start + this->m_data.size(); }
+
+            void load(u64 until) {
+                until = std::min(until, this->m_providerEnd);
+                if (until <= this->end())
+                    return;
+
+                const u64 from = this->end();
+                this->m_data.resize(until - this->m_start);
+                this->m_provider->readRaw(from, this->m_data.data() + (from - this->m_start), until - from);
+                this->m_snapshot.apply(from, this->m_data.data() + (from - this->m_start), until - from);
+            }
+
+            prv::Provider *m_provider;
+            const prv::DataSnapshot &m_snapshot;
+            u64 m_start, m_providerEnd;
+            std::vector<u8> m_data;
+        };
+
+        struct Character {
+            u32 size;
+            bool ascii;
+        };
+
+        [[nodiscard]] constexpr bool isPrintableAscii(u32 c) { return c >= 0x20 && c <= 0x7E; }
+        [[nodiscard]] constexpr bool isPrintableLatin1(u32 c) { return isPrintableAscii(c) || (c >= 0xA0 && c <= 0xFF); }
+        [[nodiscard]] constexpr bool isContinuationByte(u8 byte) { return (byte & 0xC0) == 0x80; }
+
+        /*
+         * Strings of one encoding at one alignment. ASCII and UTF-8 share a lane whose characters can start at any byte,
+         * wide encodings have one lane per possible alignment of their code units
+         */
+        class Lane {
+        public:
+            Lane(StringEncoding encoding, u32 alignment, bool ascii, bool utf8) : m_encoding(encoding), m_alignment(alignment), m_ascii(ascii), m_utf8(utf8) {
+                switch (encoding) {
+                    case StringEncoding::UTF16LE:
+                    case StringEncoding::UTF16BE:
+                        this->m_unitSize = 2;
+                        break;
+                    case StringEncoding::UTF32LE:
+                    case StringEncoding::UTF32BE:
+                        this->m_unitSize = 4;
+                        break;
+                    default:
+                        this->m_unitSize = 0;
+                        break;
+                }
+            }
+
+            void scan(ChunkData &data, u64 base, u64 start, u64 end, u32 minimumLength, std::vector<FoundString> &strings) const {
+                u64 position = this->findStart(data, base, start);
+
+                while (position < end) {
+                    auto character = this->getCharacter(data, position);
+                    if (character.size == 0) {
+                        position += this->isWide() ? this->m_unitSize : 1;
+                        continue;
+                    }
+
+                    // Strings that start in this chunk are followed past its end, until the end of the next chunk at most
+                    const u64 stringStart = position;
+                    const u64 limit = end - stringStart >= StringExtractor::SplitSize ? end : end + StringExtractor::ChunkSize;
+                    u32 length = 0;
+                    bool ascii = true;
+                    while (character.size != 0) {
+                        length++;
+                        ascii = ascii && character.ascii;
+                        position += character.size;
+
+                        if (position >= limit)
+                            break;
+
+                        character = this->getCharacter(data, position);
+                    }
+
+                    if (length < minimumLength)
+                        continue;
+
+                    if (this->isWide())
+                        strings.push_back({ stringStart, size_t(position - stringStart), this->m_encoding });
+                    else if (ascii && this->m_ascii)
+                        strings.push_back({ stringStart, size_t(position - stringStart), StringEncoding::ASCII });
+                    else if (!ascii)
+                        strings.push_back({ stringStart, size_t(position - stringStart), StringEncoding::UTF8 });
+                }
+            }
+
+        private:
+            [[nodiscard]] bool isWide() const { return this->m_unitSize != 0; }
+
+            Character getCharacter(ChunkData &data, u64 address) const {
+                if (this->isWide()) {
+                    if (data.ensure(address, this->m_unitSize) < this->m_unitSize)
+                        return { 0, false };
+
+                    const u8 *bytes = data.at(address);
+                    const bool bigEndian = this->m_encoding == StringEncoding::UTF16BE || this->m_encoding == StringEncoding::UTF32BE;
+
+                    u32 value = 0;
+                    for (u32 i = 0; i < this->m_unitSize; i++)
+                        value |= u32(bytes[bigEndian ? (this->m_unitSize - 1 - i) : i]) << (i * 8);
+
+                    return { isPrintableLatin1(value) ? this->m_unitSize : 0, value < 0x80 };
+                }
+
+                if (data.ensure(address, 1) == 0)
+                    return { 0, false };
+
+                const u8 *bytes = data.at(address);
+                if (isPrintableAscii(bytes[0]))
+                    return { 1, true };
+                if (!this->m_utf8)
+                    return { 0, false };
+
+                // Only accept well-formed, non-overlong sequences of printable code points
+                u32 size, codePoint;
+                if ((bytes[0] & 0xE0) == 0xC0)      size = 2, codePoint = bytes[0] & 0x1F;
+                else if ((bytes[0] & 0xF0) == 0xE0) size = 3, codePoint = bytes[0] & 0x0F;
+                else if ((bytes[0] & 0xF8) == 0xF0) size = 4, codePoint = bytes[0] & 0x07;
+                else
+                    return { 0, false };
+
+                if (data.ensure(address, size) < size)
+                    return { 0, false };
+
+                bytes = data.at(address);
+                for (u32 i = 1; i < size; i++) {
+                    if (!isContinuationByte(bytes[i]))
+                        return { 0, false };
+
+                    codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+                }
+
+                constexpr static u32 MinimumCodePoint[] = { 0, 0, 0x80, 0x800, 0x1'0000 };
+                if (codePoint < MinimumCodePoint[size] || codePoint < 0xA0 || codePoint > 0x10'FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+                    return { 0, false };
+
+                return { size, false };
+            }
+
+            /* Returns the start of the character that ends exactly at position, if there is one */
+            std::optional<u64> findPreviousCharacter(ChunkData &data, u64 base, u64 position) const {
+                if (this->isWide()) {
+                    if (position >= base + this->m_unitSize && this->getCharacter(data, position - this->m_unitSize).size != 0)
+                        return position - this->m_unitSize;
+
+                    return std::nullopt;
+                }
+
+                for (u64 lead = position; lead > base && lead + 4 > position; ) {
+                    lead--;
+
+                    if (isContinuationByte(*data.at(lead)) && this->m_utf8)
+                        continue;
+
+                    if (this->getCharacter(data, lead).size == position - lead)
+                        return lead;
+
+                    break;
+                }
+
+                return std::nullopt;
+            }
+
+            /* Returns the first position at or after start where a string belonging to this chunk may begin */
+            u64 findStart(ChunkData &data, u64 base, u64 start) const {
+                u64 position = start;
+                std::optional<u64> inProgress;
+
+                if (this->isWide()) {
+                    position += (this->m_alignment + this->m_unitSize - (start - base) % this->m_unitSize) % this->m_unitSize;
+
+                    if (position >= base + this->m_unitSize && this->getCharacter(data, position - this->m_unitSize).size != 0)
+                        inProgress = position - this->m_unitSize;
+                } else {
+                    // A character covering the byte before start can only begin at one of the 4 bytes before it
+                    for (u64 lead = start; lead > base && lead + 4 > start; ) {
+                        lead--;
+
+                        if (isContinuationByte(*data.at(lead)) && this->m_utf8)
+                            continue;
+
+                        auto character = this->getCharacter(data, lead);
+                        if (character.size != 0 && lead + character.size >= start) {
+                            inProgress = lead;
+                            position = lead + character.size;
+                        }
+
+                        break;
+                    }
+                }
+
+                if (!inProgress.has_value())
+                    return position;
+
+                // A string that's in progress at the start of the chunk was split here if it started at least SplitSize bytes earlier
+                u64 stringStart = *inProgress;
+                while (start - stringStart < StringExtractor::SplitSize) {
+                    auto previous = this->findPreviousCharacter(data, base, stringStart);
+                    if (!previous.has_value())
+                        break;
+
+                    stringStart = *previous;
+                }
+
+                if (start - stringStart >= StringExtractor::SplitSize)
+                    return position;
+
+                // Otherwise it belongs to the previous chunk, which followed it until the end of this chunk at most
+                const u64 end = start + StringExtractor::ChunkSize;
+                for (auto character = this->getCharacter(data, position); character.size != 0 && position < end; character = this->getCharacter(data, position))
+                    position += character.size;
+
+                return position;
+            }
+
+            StringEncoding m_encoding;
+            u32 m_unitSize;
+            u32 m_alignment;
+            bool m_ascii, m_utf8;
+        };
+
+        /* Converts the bytes of a string to UTF-8. Wide strings only ever contain Latin-1 characters */
+        std::string decodeString(const u8 *bytes, size_t size, StringEncoding encoding) {
+            u32 unitSize = 1;
+            bool bigEndian = false;
+            switch (encoding) {
+                case StringEncoding::ASCII:
+                case StringEncoding::UTF8:
+                    return { bytes, bytes + size };
+                case StringEncoding::UTF16LE: unitSize = 2; break;
+                case StringEncoding::UTF16BE: unitSize = 2; bigEndian = true; break;
+                case StringEncoding::UTF32LE: unitSize = 4; break;
+                case StringEncoding::UTF32BE: unitSize = 4; bigEndian = true; break;
+            }
+
+            std::string result;
+            for (size_t i = 0; i + unitSize <= size; i += unitSize) {
+                u8 c = bytes[bigEndian ? (i + unitSize - 1) : i];
+
+                if (c < 0x80) {
+                    result += char(c);
+                } else {
+                    result += char(0xC0 | (c >> 6));
+                    result += char(0x80 | (c & 0x3F));
+                }
+            }
+
+            return result;
+        }
+
+        constexpr u64 HashMultiplier = 0x9E37'79B9'7F4A'7C15;
+
+        [[nodiscard]] constexpr u64 mixHash(u64 hash, u64 value) {
+            hash = (hash ^ value) * HashMultiplier;
+            return hash ^ (hash >> 29);
+        }
+
+        /* Fast, non-cryptographic hash that's only used to tell if the data changed since strings were last extracted from it */
+        u64 hashBytes(const u8 *bytes, size_t size) {
+            u64 hash = size;
+
+            size_t i = 0;
+            for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+                u64 value;
+                std::memcpy(&value, bytes + i, sizeof(value));
+                hash = mixHash(hash, value);
+            }
+
+            u64 tail = 0;
+            std::memcpy(&tail, bytes + i, size - i);
+
+            return mixHash(hash, tail);
+        }
+
+        std::vector<Lane> getLanes(const StringExtractor::Settings &settings) {
+            auto enabled = [&](StringEncoding encoding) {
+                return std::find(settings.encodings.begin(), settings.encodings.end(), encoding) != settings.encodings.end();
+            };
+
+            std::vector<Lane> lanes;
+
+            const bool ascii = enabled(StringEncoding::ASCII), utf8 = enabled(StringEncoding::UTF8);
+            if (ascii || utf8)
+                lanes.emplace_back(StringEncoding::ASCII, 0, ascii, utf8);
+
+            for (auto [encoding, unitSize] : { std::pair<StringEncoding, u32> { StringEncoding::UTF16LE, 2 }, { StringEncoding::UTF16BE, 2 }, { StringEncoding::UTF32LE, 4 }, { StringEncoding::UTF32BE, 4 } }) {
+                if (!enabled(encoding))
+                    continue;
+
+                for (u32 alignment = 0; alignment < unitSize; alignment++)
+                    lanes.emplace_back(encoding, alignment, false, false);
+            }
+
+            return lanes;
+        }
+
+    }
+
+    StringExtractor::~StringExtractor() {
+        this->cancel();
+    }
+
+    void StringExtractor::start(prv::Provider *provider, const Settings &settings) {
+        this->cancel();
+
+        this->m_cancelled = false;
+        this->m_chunkCount = (provider->getSize() + ChunkSize - 1) / ChunkSize;
+        this->m_nextChunk = 0;
+        this->m_finishedChunks = 0;
+
+        {
+            std::scoped_lock lock(this->m_resultMutex);
+
+            this->m_chunkResults.clear();
+            this->m_chunkResults.resize(this->m_chunkCount);
+            this->m_nextPublishedChunk = 0;
+            this->m_published = { };
+            this->m_contentHash = mixHash(0, provider->getSize());
+        }
+
+        const u32 workerCount = provider->isThreadSafe() ? std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(this->m_chunkCount, 1)) : 1;
+        this->m_activeWorkers = workerCount;
+
+        // Workers only read the raw data themselves, patches and overlays may be edited while they run
+        auto snapshot = std::make_shared<const prv::DataSnapshot>(provider->takeSnapshot());
+
+        for (u32 i = 0; i < workerCount; i++) {
+            this->m_workers.emplace_back([this, provider, snapshot, settings] {
+                for (size_t chunk = this->m_nextChunk++; chunk < this->m_chunkCount && !this->m_cancelled; chunk = this->m_nextChunk++)
+                    this->processChunk(provider, *snapshot, settings, chunk);
+
+                this->m_activeWorkers--;
+            });
+        }
+    }
+
+    void StringExtractor::cancel() {
+        this->m_cancelled = true;
+
+        for (auto &worker : this->m_workers)
+            worker.join();
+
+        this->m_workers.clear();
+
+        std::scoped_lock lock(this->m_resultMutex);
+        this->m_published = { };
+    }
+
+    void StringExtractor::processChunk(prv::Provider *provider, const prv::DataSnapshot &snapshot, const Settings &settings, size_t chunk) {
+        const u64 base = provider->getBaseAddress();
+        const u64 start = base + chunk * ChunkSize;
+        const u64 end = std::min<u64>(start + ChunkSize, base + provider->getSize());
+
+        // The bytes before the chunk are needed to tell if a string is already in progress at its start and where it began
+        constexpr static u64 LookBehind = SplitSize + 4;
+        ChunkData data(provider, snapshot, std::max<u64>(start, base + LookBehind) - LookBehind, end);
+
+        ChunkResult result;
+        for (const auto &lane : getLanes(settings)) {
+            if (this->m_cancelled)
+                return;
+
+            lane.scan(data, base, start, end, settings.minimumLength, result.strings);
+        }
+
+        std::sort(result.strings.begin(), result.strings.end(), [](const auto &left, const auto &right) { return left.offset < right.offset; });
+
+        result.hash = hashBytes(data.at(start), end - start);
+
+        // The bytes of all strings are still loaded, so converting them here saves reading them again when they're displayed or filtered
+        for (const auto &string : result.strings)
+            result.texts.add(decodeString(data.at(string.offset), string.size, string.encoding));
+
+        this->publishChunk(chunk, std::move(result));
+        this->m_finishedChunks++;
+    }
+
+    void StringExtractor::publishChunk(size_t chunk, ChunkResult &&result) {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        this->m_chunkResults[chunk] = std::move(result);
+
+        while (this->m_nextPublishedChunk < this->m_chunkCount && this->m_chunkResults[this->m_nextPublishedChunk].has_value()) {
+            auto &results = *this->m_chunkResults[this->m_nextPublishedChunk];
+            this->m_published.strings.insert(this->m_published.strings.end(), results.strings.begin(), results.strings.end());
+            this->m_published.texts.append(results.texts);
+            this->m_contentHash = mixHash(this->m_contentHash, results.hash);
+
+            this->m_chunkResults[this->m_nextPublishedChunk].reset();
+            this->m_nextPublishedChunk++;
+        }
+    }
+
+    std::optional<u64> StringExtractor::getContentHash() {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        if (this->m_cancelled || this->m_nextPublishedChunk != this->m_chunkCount)
+            return std::nullopt;
+
+        return this->m_contentHash;
+    }
+
+    void StringExtractor::takeResults(std::vector<FoundString> &strings, StringIndex &texts) {
+        ChunkResult published;
+
+        {
+            std::scoped_lock lock(this->m_resultMutex);
+            std::swap(published, this->m_published);
+        }
+
+        strings.insert(strings.end(), published.strings.begin(), published.strings.end());
+        texts.append(published.texts);
+    }
+
+    bool StringExtractor::hasPendingResults() {
+        std::scoped_lock lock(this->m_resultMutex);
+
+        return !this->m_published.strings.empty();
+    }
+
+    std::string StringExtractor::readString(prv::Provider *provider, const FoundString &string) {
+        std::vector<u8> bytes(string.size);
+        provider->read(string.offset, bytes.data(), bytes.size());
+
+        return decodeString(bytes.data(), bytes.size(), string.encoding);
+    }
+
+    const char* StringExtractor::getEncodingName(StringEncoding encoding) {
+        switch (encoding) {
+            case StringEncoding::ASCII:   return "ASCII";
+            case StringEncoding::UTF8:    return "UTF-8";
+            case StringEncoding::UTF16LE: return "UTF-16LE";
+            case StringEncoding::UTF16BE: return "UTF-16BE";
+            case StringEncoding::UTF32LE: return "UTF-32LE";
+            case StringEncoding::UTF32BE: return "UTF-32BE";
+        }
+
+        return "";
+    }
+
+}
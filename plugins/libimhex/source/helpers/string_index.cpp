@@ -0,0 +1,77 @@
+#include <hex/helpers/string_index.hpp>
+
+#include <algorithm>
+
+namespace hex {
+
+    static u32 getTrigram(const char *data) {
+        return u32(u8(data[0])) | u32(u8(data[1])) << 8 | u32(u8(data[2])) << 16;
+    }
+
+    void StringIndex::add(std::string_view string) {
+        this->m_data += string;
+        this->m_offsets.push_back(this->m_data.size());
+    }
+
+    void StringIndex::append(const StringIndex &other) {
+        const size_t base = this->m_data.size();
+
+        this->m_data += other.m_data;
+        for (size_t i = 1; i < other.m_offsets.size(); i++)
+            this->m_offsets.push_back(base + other.m_offsets[i]);
+    }
+
+    void StringIndex::clear() {
+        this->m_data.clear();
+        this->m_offsets = { 0 };
+
+        this->m_trigrams.clear();
+        this->m_indexedCount = 0;
+    }
+
+    void StringIndex::updateIndex() {
+        for (; this->m_indexedCount < this->size(); this->m_indexedCount++) {
+            const auto string = this->get(this->m_indexedCount);
+
+            for (size_t i = 0; i + TrigramSize <= string.size(); i++) {
+                // Strings are indexed in order so a repeated trigram of the same string is always at the back of the list
+                auto &strings = this->m_trigrams[getTrigram(string.data() + i)];
+                if (strings.empty() || strings.back() != this->m_indexedCount)
+                    strings.push_back(this->m_indexedCount);
+            }
+        }
+    }
+
+    void StringIndex::find(std::string_view needle, size_t from, std::vector<size_t> &result) {
+        if (needle.size() < TrigramSize) {
+            for (size_t i = from; i < this->size(); i++) {
+                if (this->get(i).find(needle) != std::string_view::npos)
+                    result.push_back(i);
+            }
+
+            return;
+        }
+
+        this->updateIndex();
+
+        const std::vector<u32> *candidates = nullptr;
+        for (size_t i = 0; i + TrigramSize <= needle.size(); i++) {
+            auto it = this->m_trigrams.find(getTrigram(needle.data() + i));
+            if (it == this->m_trigrams.end())
+                return;
+
+            if (candidates == nullptr || it->second.size() < candidates->size())
+                candidates = &it->second;
+        }
+
+        for (auto it = std::lower_bound(candidates->begin(), candidates->end(), from); it != candidates->end(); ++it) {
+            if (this->get(*it).find(needle) != std::string_view::npos)
+                result.push_back(*it);
+        }
+    }
+
+    void StringIndex::narrow(std::string_view needle, std::vector<size_t> &indices) const {
+        std::erase_if(indices, [&](size_t index) { return this->get(index).find(needle) == std::string_view::npos; });
+    }
+
+}
@@ -0,0 +1,115 @@
+#include <hex/providers/cached_provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    void BlockCache::read(u64 offset, void *buffer, size_t size, u64 dataStart, size_t dataSize, const ReadFunction &readFunction) {
+        if (buffer == nullptr || size == 0 || offset < dataStart || (offset - dataStart) + size > dataSize)
+            return;
+
+        std::scoped_lock lock(this->m_mutex);
+
+        // Blocks are aligned to the start of the data so a new base address means new blocks
+        if (dataStart != this->m_dataStart) {
+            this->m_blocks.clear();
+            this->m_blockLookup.clear();
+            this->m_lastMissedBlock.reset();
+            this->m_dataStart = dataStart;
+        }
+
+        // Reads spanning more than the whole cache would only evict everything else
+        if (size > BlockSize * (this->m_maxBlocks / 2)) {
+            readFunction(offset, buffer, size);
+            return;
+        }
+
+        auto bytes = static_cast<u8*>(buffer);
+        u64 relativeOffset = offset - dataStart;
+
+        while (size > 0) {
+            auto &block = this->getBlock(relativeOffset / BlockSize, dataStart, dataSize, readFunction);
+
+            u64 blockOffset = relativeOffset % BlockSize;
+            size_t copySize = std::min<size_t>(size, block.data.size() - blockOffset);
+
+            std::memcpy(bytes, block.data.data() + blockOffset, copySize);
+
+            relativeOffset += copySize;
+            bytes += copySize;
+            size -= copySize;
+        }
+    }
+
+    const BlockCache::Block& BlockCache::getBlock(u64 index, u64 dataStart, size_t dataSize, const ReadFunction &readFunction) {
+        if (auto it = this->m_blockLookup.find(index); it != this->m_blockLookup.end()) {
+            this->m_blocks.splice(this->m_blocks.begin(), this->m_blocks, it->second);
+            return this->m_blocks.front();
+        }
+
+        const u64 blockCount = (dataSize + BlockSize - 1) / BlockSize;
+
+        // Sequential misses read the following blocks as well, stopping at the first one that's already cached
+        u64 readCount = 1;
+        if (this->m_lastMissedBlock.has_value() && *this->m_lastMissedBlock + 1 == index) {
+            while (readCount < ReadAheadBlocks && index + readCount < blockCount && !this->m_blockLookup.contains(index + readCount))
+                readCount++;
+        }
+        this->m_lastMissedBlock = index + readCount - 1;
+
+        u64 readOffset = index * BlockSize;
+        size_t readSize = std::min<u64>(readCount * BlockSize, dataSize - readOffset);
+
+        std::vector<u8> data(readSize, 0x00);
+        readFunction(dataStart + readOffset, data.data(), data.size());
+
+        // Insert the read-ahead blocks first so the requested one ends up as the most recently used
+        for (u64 i = readCount; i > 0; i--) {
+            auto begin = data.begin() + (i - 1) * BlockSize;
+            auto end = data.begin() + std::min<size_t>(i * BlockSize, data.size());
+
+            this->insertBlock(index + i - 1, std::vector<u8>(begin, end));
+        }
+
+        return this->m_blocks.front();
+    }
+
+    void BlockCache::insertBlock(u64 index, std::vector<u8> &&data) {
+        this->m_blocks.push_front(Block { index, std::move(data) });
+        this->m_blockLookup[index] = this->m_blocks.begin();
+
+        while (this->m_blocks.size() > this->m_maxBlocks) {
+            this->m_blockLookup.erase(this->m_blocks.back().index);
+            this->m_blocks.pop_back();
+        }
+    }
+
+    void BlockCache::invalidate(u64 offset, size_t size) {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (size == 0 || offset + size <= this->m_dataStart)
+            return;
+
+        u64 relativeOffset = offset > this->m_dataStart ? offset - this->m_dataStart : 0;
+        u64 firstBlock = relativeOffset / BlockSize;
+        u64 lastBlock = (offset + size - 1 - this->m_dataStart) / BlockSize;
+
+        std::erase_if(this->m_blocks, [&](const Block &block) {
+            if (block.index < firstBlock || block.index > lastBlock)
+                return false;
+
+            this->m_blockLookup.erase(block.index);
+            return true;
+        });
+    }
+
+    void BlockCache::clear() {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->m_blocks.clear();
+        this->m_blockLookup.clear();
+        this->m_lastMissedBlock.reset();
+    }
+
+}
@@ -0,0 +1,23 @@
+#include <hex/providers/overlay.hpp>
+
+#include <hex/providers/provider.hpp>
+
+namespace hex::prv {
+
+    void Overlay::setAddress(u64 address) {
+        auto oldAddress = this->m_address;
+        auto oldSize = this->getSize();
+
+        this->m_address = address;
+        this->m_provider->updateOverlay(this, oldAddress, oldSize);
+    }
+
+    void Overlay::setData(std::vector<u8> data) {
+        auto oldAddress = this->m_address;
+        auto oldSize = this->getSize();
+
+        this->m_data = std::move(data);
+        this->m_provider->updateOverlay(this, oldAddress, oldSize);
+    }
+
+}
@@ -0,0 +1,299 @@
+#include <hex/providers/patch_tree.hpp>
+
+#include <algorithm>
+
+namespace hex::prv {
+
+    /* Treap priority derived from the extent offset. Offsets are unique so no random state is needed */
+    static u64 getPriority(u64 offset) {
+        offset += 0x9E37'79B9'7F4A'7C15;
+        offset = (offset ^ (offset >> 30)) * 0xBF58'476D'1CE4'E5B9;
+        offset = (offset ^ (offset >> 27)) * 0x94D0'49BB'1331'11EB;
+        return offset ^ (offset >> 31);
+    }
+
+    PatchTree::PatchTree(const std::map<u64, u8> &patches) {
+        std::vector<u8> run;
+        u64 runAddress = 0;
+
+        for (const auto &[address, value] : patches) {
+            if (!run.empty() && address != runAddress + run.size()) {
+                this->write(runAddress, run.data(), run.size());
+                run.clear();
+            }
+
+            if (run.empty())
+                runAddress = address;
+            run.push_back(value);
+        }
+
+        if (!run.empty())
+            this->write(runAddress, run.data(), run.size());
+    }
+
+    PatchTree::NodePtr PatchTree::makeNode(u64 offset, std::shared_ptr<const std::vector<u8>> data, NodePtr left, NodePtr right) {
+        return std::make_shared<const Node>(Node { offset, std::move(data), std::move(left), std::move(right) });
+    }
+
+    PatchTree::NodePtr PatchTree::withChildren(const NodePtr &node, NodePtr left, NodePtr right) {
+        return makeNode(node->offset, node->data, std::move(left), std::move(right));
+    }
+
+    std::pair<PatchTree::NodePtr, PatchTree::NodePtr> PatchTree::split(const NodePtr &node, u64 key) {
+        if (node == nullptr)
+            return { };
+
+        if (node->offset < key) {
+            auto [left, right] = split(node->right, key);
+            return { withChildren(node, node->left, std::move(left)), std::move(right) };
+        } else {
+            auto [left, right] = split(node->left, key);
+            return { std::move(left), withChildren(node, std::move(right), node->right) };
+        }
+    }
+
+    PatchTree::NodePtr PatchTree::merge(const NodePtr &left, const NodePtr &right) {
+        if (left == nullptr) return right;
+        if (right == nullptr) return left;
+
+        if (getPriority(left->offset) > getPriority(right->offset))
+            return withChildren(left, left->left, merge(left->right, right));
+        else
+            return withChildren(right, merge(left, right->left), right->right);
+    }
+
+    std::pair<PatchTree::NodePtr, PatchTree::NodePtr> PatchTree::popMin(const NodePtr &node) {
+        if (node->left == nullptr)
+            return { node->right, node };
+
+        auto [rest, min] = popMin(node->left);
+        return { withChildren(node, std::move(rest), node->right), std::move(min) };
+    }
+
+    std::pair<PatchTree::NodePtr, PatchTree::NodePtr> PatchTree::popMax(const NodePtr &node) {
+        if (node->right == nullptr)
+            return { node->left, node };
+
+        auto [rest, max] = popMax(node->right);
+        return { withChildren(node, node->left, std::move(rest)), std::move(max) };
+    }
+
+    size_t PatchTree::countBytes(const Node *node) {
+        if (node == nullptr)
+            return 0;
+
+        return node->data->size() + countBytes(node->left.get()) + countBytes(node->right.get());
+    }
+
+    void PatchTree::write(u64 offset, const void *buffer, size_t size) {
+        auto bytes = static_cast<const u8*>(buffer);
+
+        while (size > 0) {
+            size_t extentSize = std::min<u64>(size, MaxExtentSize - (offset % MaxExtentSize));
+
+            this->writeExtent(offset, bytes, extentSize);
+
+            offset += extentSize;
+            bytes += extentSize;
+            size -= extentSize;
+        }
+    }
+
+    void PatchTree::clear() {
+        this->m_root = nullptr;
+        this->m_byteCount = 0;
+    }
+
+    void PatchTree::writeExtent(u64 offset, const u8 *buffer, size_t size) {
+        const u64 end = offset + size;
+
+        auto [left, rest] = split(this->m_root, offset);
+        auto [middle, right] = split(rest, end);
+
+        u64 newOffset = offset;
+        std::vector<u8> head, tail;
+        size_t removedBytes = countBytes(middle.get());
+
+        // Merge with an extent that starts before the write and overlaps or touches it
+        if (left != nullptr) {
+            auto [leftRest, prev] = popMax(left);
+
+            if (prev->end() > offset || (prev->end() == offset && offset % MaxExtentSize != 0)) {
+                newOffset = prev->offset;
+                head.assign(prev->data->begin(), prev->data->begin() + (offset - prev->offset));
+                if (prev->end() > end)
+                    tail.assign(prev->data->begin() + (end - prev->offset), prev->data->end());
+
+                removedBytes += prev->data->size();
+                left = std::move(leftRest);
+            }
+        }
+
+        // Keep the part of the last overwritten extent that reaches past the write
+        if (middle != nullptr) {
+            auto [middleRest, last] = popMax(middle);
+
+            if (last->end() > end)
+                tail.assign(last->data->begin() + (end - last->offset), last->data->end());
+        }
+
+        // Merge with an extent that directly follows the write inside the same block
+        if (right != nullptr && end % MaxExtentSize != 0) {
+            auto [rightRest, next] = popMin(right);
+
+            if (next->offset == end) {
+                tail.assign(next->data->begin(), next->data->end());
+
+                removedBytes += next->data->size();
+                right = std::move(rightRest);
+            }
+        }
+
+        auto data = std::make_shared<std::vector<u8>>();
+        data->reserve(head.size() + size + tail.size());
+        data->insert(data->end(), head.begin(), head.end());
+        data->insert(data->end(), buffer, buffer + size);
+        data->insert(data->end(), tail.begin(), tail.end());
+
+        this->m_byteCount += data->size();
+        this->m_byteCount -= removedBytes;
+
+        this->m_root = merge(merge(left, makeNode(newOffset, std::move(data), nullptr, nullptr)), right);
+    }
+
+    void PatchTree::erase(u64 offset, size_t size) {
+        if (size == 0)
+            return;
+
+        const u64 end = offset + size;
+
+        auto [left, rest] = split(this->m_root, offset);
+        auto [middle, right] = split(rest, end);
+
+        size_t removedBytes = countBytes(middle.get());
+        NodePtr head, tail;
+
+        // Erasing only ever shrinks extents so the pieces that are left over stay inside of their block
+        if (left != nullptr) {
+            auto [leftRest, prev] = popMax(left);
+
+            if (prev->end() > offset) {
+                head = makeNode(prev->offset, std::make_shared<const std::vector<u8>>(prev->data->begin(), prev->data->begin() + (offset - prev->offset)), nullptr, nullptr);
+                if (prev->end() > end)
+                    tail = makeNode(end, std::make_shared<const std::vector<u8>>(prev->data->begin() + (end - prev->offset), prev->data->end()), nullptr, nullptr);
+
+                removedBytes += prev->data->size();
+                left = std::move(leftRest);
+            }
+        }
+
+        if (middle != nullptr) {
+            auto [middleRest, last] = popMax(middle);
+
+            if (last->end() > end)
+                tail = makeNode(end, std::make_shared<const std::vector<u8>>(last->data->begin() + (end - last->offset), last->data->end()), nullptr, nullptr);
+        }
+
+        if (head != nullptr) removedBytes -= head->data->size();
+        if (tail != nullptr) removedBytes -= tail->data->size();
+        this->m_byteCount -= removedBytes;
+
+        this->m_root = merge(merge(merge(left, head), tail), right);
+    }
+
+    PatchTree PatchTree::extract(u64 offset, size_t size) const {
+        PatchTree result;
+
+        if (size == 0)
+            return result;
+
+        const u64 end = offset + size;
+
+        auto [left, rest] = split(this->m_root, offset);
+        auto [middle, right] = split(rest, end);
+
+        NodePtr head;
+
+        // Only the extents cut by the range boundaries need to be copied
+        if (left != nullptr) {
+            auto [leftRest, prev] = popMax(left);
+
+            if (prev->end() > offset) {
+                auto to = std::min(prev->end(), end);
+                head = makeNode(offset, std::make_shared<const std::vector<u8>>(prev->data->begin() + (offset - prev->offset), prev->data->begin() + (to - prev->offset)), nullptr, nullptr);
+            }
+        }
+
+        if (middle != nullptr) {
+            auto [middleRest, last] = popMax(middle);
+
+            if (last->end() > end)
+                middle = merge(middleRest, makeNode(last->offset, std::make_shared<const std::vector<u8>>(last->data->begin(), last->data->begin() + (end - last->offset)), nullptr, nullptr));
+        }
+
+        result.m_root = merge(head, middle);
+        result.m_byteCount = countBytes(result.m_root.get());
+
+        return result;
+    }
+
+    void PatchTree::replace(u64 offset, size_t size, const PatchTree &patches) {
+        this->erase(offset, size);
+
+        auto inserted = patches.extract(offset, size);
+        if (inserted.empty())
+            return;
+
+        auto [left, right] = split(this->m_root, offset);
+
+        this->m_root = merge(merge(left, inserted.m_root), right);
+        this->m_byteCount += inserted.m_byteCount;
+    }
+
+    std::optional<u8> PatchTree::get(u64 address) const {
+        const Node *node = this->m_root.get();
+
+        while (node != nullptr) {
+            if (address < node->offset)
+                node = node->left.get();
+            else if (address >= node->end())
+                node = node->right.get();
+            else
+                return (*node->data)[address - node->offset];
+        }
+
+        return std::nullopt;
+    }
+
+    bool PatchTree::overlaps(u64 offset, size_t size) const {
+        if (size == 0)
+            return false;
+
+        const u64 end = offset + size;
+        const Node *node = this->m_root.get();
+
+        // Extents are disjoint so any of them intersecting the range is found on a single path down the tree
+        while (node != nullptr) {
+            if (node->end() <= offset)
+                node = node->right.get();
+            else if (node->offset >= end)
+                node = node->left.get();
+            else
+                return true;
+        }
+
+        return false;
+    }
+
+    std::map<u64, u8> PatchTree::toMap() const {
+        std::map<u64, u8> result;
+
+        this->forEach([&result](u64 address, std::span<const u8> bytes) {
+            for (u64 i = 0; i < bytes.size(); i++)
+                result.emplace_hint(result.end(), address + i, bytes[i]);
+        });
+
+        return result;
+    }
+
+}
@@ -2,21 +2,22 @@
 
 #include <hex.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <map>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace hex::prv {
 
     Provider::Provider() {
-        this->m_patches.emplace_back();
     }
 
     Provider::~Provider() {
-        for (auto &overlay : this->m_overlays)
-            this->deleteOverlay(overlay);
+        while (!this->m_overlays.empty())
+            this->deleteOverlay(this->m_overlays.front());
     }
 
     void Provider::read(u64 offset, void *buffer, size_t size, bool overlays) {
@@ -27,6 +28,20 @@ namespace hex::prv {
         this->read(offset + this->getBaseAddress(), buffer, size);
     }
 
+    std::future<void> Provider::readAsync(std::vector<ReadRequest> requests, bool overlays) {
+        for (const auto &request : requests)
+            this->read(request.offset, request.buffer, request.size, overlays);
+
+        std::promise<void> done;
+        done.set_value();
+
+        return done.get_future();
+    }
+
+    std::optional<MappedSpan> Provider::tryGetSpan(u64 offset, size_t size) {
+        return std::nullopt;
+    }
+
     void Provider::write(u64 offset, const void *buffer, size_t size) {
         this->writeRaw(offset, buffer, size);
     }
@@ -36,42 +51,126 @@ namespace hex::prv {
     }
 
     void Provider::save() { }
-    void Provider::saveAs(const std::string &path) { }
+    void Provider::saveAs(const std::string &path, const DataSnapshot &snapshot, const ProgressCallback &progress) { }
 
     void Provider::resize(ssize_t newSize) { }
 
+    std::vector<Provider::OverlayEntry> Provider::getOverlappingOverlays(u64 offset, size_t size) {
+        std::vector<OverlayEntry> overlapping;
+
+        if (this->m_overlayIndex.empty() || size == 0)
+            return overlapping;
+
+        // No overlay that starts further than the largest overlay size in front of the range can reach into it
+        u64 maxOverlaySize = *this->m_overlaySizes.rbegin();
+        auto begin = this->m_overlayIndex.lower_bound(offset >= maxOverlaySize ? offset - maxOverlaySize + 1 : 0);
+        auto end = this->m_overlayIndex.lower_bound(offset + size);
+
+        for (auto it = begin; it != end; ++it) {
+            if (it->first + it->second.overlay->getSize() > offset)
+                overlapping.push_back(it->second);
+        }
+
+        return overlapping;
+    }
+
     void Provider::applyOverlays(u64 offset, void *buffer, size_t size) {
-        for (auto &overlay : this->m_overlays) {
+        auto overlapping = this->getOverlappingOverlays(offset, size);
+
+        // Overlapping overlays are applied in the order they were created in so newer ones win
+        std::sort(overlapping.begin(), overlapping.end(), [](const auto &left, const auto &right) { return left.order < right.order; });
+
+        for (const auto &[order, overlay] : overlapping) {
             auto overlayOffset = overlay->getAddress();
             auto overlaySize = overlay->getSize();
 
-            s128 overlapMin = std::max(offset, overlayOffset);
-            s128 overlapMax = std::min(offset + size, overlayOffset + overlaySize);
-             if (overlapMax > overlapMin)
-                 std::memcpy(static_cast<u8*>(buffer) + std::max<s128>(0, overlapMin - offset), overlay->getData().data() + std::max<s128>(0, overlapMin - overlayOffset), overlapMax - overlapMin);
+            u64 overlapMin = std::max(offset, overlayOffset);
+            u64 overlapMax = std::min(offset + size, overlayOffset + overlaySize);
+            if (overlapMax > overlapMin)
+                std::memcpy(static_cast<u8*>(buffer) + (overlapMin - offset), overlay->getData().data() + (overlapMin - overlayOffset), overlapMax - overlapMin);
         }
     }
 
+    bool Provider::hasOverlays(u64 offset, size_t size) {
+        return !this->getOverlappingOverlays(offset, size).empty();
+    }
 
-    std::map<u64, u8>& Provider::getPatches() {
-        return *(this->m_patches.end() - 1 - this->m_patchTreeOffset);
+    PatchTree& Provider::getPatches() {
+        return this->m_patches;
     }
 
     void Provider::applyPatches() {
-        for (auto &[patchAddress, patch] : getPatches())
-            this->writeRaw(patchAddress, &patch, 1);
+        getPatches().forEach([this](u64 address, std::span<const u8> bytes) {
+            this->writeRaw(address, bytes.data(), bytes.size());
+        });
+    }
+
+    DataSnapshot Provider::takeSnapshot() {
+        DataSnapshot snapshot = { this->m_patches, { } };
+
+        for (auto overlay : this->m_overlays) {
+            if (overlay->getSize() > 0)
+                snapshot.overlays.emplace_back(overlay->getAddress(), overlay->getData());
+        }
+
+        return snapshot;
+    }
+
+    void DataSnapshot::apply(u64 offset, void *buffer, size_t size) const {
+        this->patches.forEachInRange(offset, size, [&](u64 address, std::span<const u8> bytes) {
+            std::memcpy(static_cast<u8*>(buffer) + (address - offset), bytes.data(), bytes.size());
+        });
+
+        // Overlays are kept in the order they were created in so newer ones win, just like in Provider::applyOverlays
+        for (const auto &[address, data] : this->overlays) {
+            u64 overlapMin = std::max(offset, address);
+            u64 overlapMax = std::min(offset + size, address + data.size());
+            if (overlapMax > overlapMin)
+                std::memcpy(static_cast<u8*>(buffer) + (overlapMin - offset), data.data() + (overlapMin - address), overlapMax - overlapMin);
+        }
     }
 
 
     Overlay* Provider::newOverlay() {
-        return this->m_overlays.emplace_back(new Overlay());
+        auto overlay = this->m_overlays.emplace_back(new Overlay(this));
+
+        this->m_overlayIndex.emplace(overlay->getAddress(), OverlayEntry { this->m_nextOverlayOrder++, overlay });
+        this->m_overlaySizes.insert(overlay->getSize());
+
+        return overlay;
     }
 
     void Provider::deleteOverlay(Overlay *overlay) {
+        this->removeFromOverlayIndex(overlay, overlay->getAddress(), overlay->getSize());
+
         this->m_overlays.erase(std::find(this->m_overlays.begin(), this->m_overlays.end(), overlay));
         delete overlay;
     }
 
+    void Provider::updateOverlay(Overlay *overlay, u64 oldAddress, u64 oldSize) {
+        auto [begin, end] = this->m_overlayIndex.equal_range(oldAddress);
+        auto entry = std::find_if(begin, end, [overlay](const auto &entry) { return entry.second.overlay == overlay; });
+        if (entry == end)
+            return;
+
+        auto order = entry->second.order;
+        this->m_overlayIndex.erase(entry);
+        this->m_overlaySizes.erase(this->m_overlaySizes.find(oldSize));
+
+        this->m_overlayIndex.emplace(overlay->getAddress(), OverlayEntry { order, overlay });
+        this->m_overlaySizes.insert(overlay->getSize());
+    }
+
+    void Provider::removeFromOverlayIndex(Overlay *overlay, u64 address, u64 size) {
+        auto [begin, end] = this->m_overlayIndex.equal_range(address);
+        auto entry = std::find_if(begin, end, [overlay](const auto &entry) { return entry.second.overlay == overlay; });
+        if (entry == end)
+            return;
+
+        this->m_overlayIndex.erase(entry);
+        this->m_overlaySizes.erase(this->m_overlaySizes.find(size));
+    }
+
     const std::list<Overlay*>& Provider::getOverlays() {
         return this->m_overlays;
     }
@@ -90,17 +189,25 @@ namespace hex::prv {
             this->m_currPage = page;
     }
 
+    u64 Provider::getCurrentPageOffset() const {
+        return PageSize * this->m_currPage;
+    }
+
+    size_t Provider::getCurrentPageSize() {
+        return std::min<size_t>(this->getActualSize() - this->getCurrentPageOffset(), PageSize);
+    }
+
 
     void Provider::setBaseAddress(u64 address) {
         this->m_baseAddress = address;
     }
 
     u64 Provider::getBaseAddress() {
-        return this->m_baseAddress + PageSize * this->m_currPage;
+        return this->m_baseAddress;
     }
 
     size_t Provider::getSize() {
-        return std::min(this->getActualSize() - PageSize * this->m_currPage, PageSize);
+        return this->getActualSize();
     }
 
     std::optional<u32> Provider::getPageOfAddress(u64 address) {
@@ -113,33 +220,105 @@ namespace hex::prv {
     }
 
     void Provider::addPatch(u64 offset, const void *buffer, size_t size) {
-        if (this->m_patchTreeOffset > 0) {
-            this->m_patches.erase(this->m_patches.end() - this->m_patchTreeOffset, this->m_patches.end());
-            this->m_patchTreeOffset = 0;
+        if (size == 0)
+            return;
+
+        // A new edit invalidates everything that could have been redone
+        while (this->m_undoJournal.size() > this->m_undoPosition) {
+            this->m_undoMemoryUsage -= this->m_undoJournal.back().getMemoryUsage(false);
+            this->m_undoJournal.pop_back();
         }
 
-        this->m_patches.push_back(getPatches());
+        auto oldPatches = this->m_patches.extract(offset, size);
+        this->m_patches.write(offset, buffer, size);
+
+        if (!this->coalesceUndoEntry(offset, size, oldPatches)) {
+            auto &entry = this->m_undoJournal.emplace_back(UndoEntry { offset, size, std::move(oldPatches), this->m_patches.extract(offset, size), std::chrono::steady_clock::now() });
+            this->m_undoMemoryUsage += entry.getMemoryUsage(true);
+            this->m_undoPosition++;
+        }
+
+        this->trimUndoJournal();
+    }
+
+    bool Provider::coalesceUndoEntry(u64 offset, size_t size, const PatchTree &oldPatches) {
+        constexpr static auto CoalesceTimeout = std::chrono::seconds(1);
+        constexpr static size_t MaxCoalescedSize = 0x100;
+
+        // Only merge single bytes typed directly after the previous edit
+        if (size != 1 || this->m_undoJournal.empty())
+            return false;
+
+        auto &entry = this->m_undoJournal.back();
+        auto now = std::chrono::steady_clock::now();
 
-        for (u64 i = 0; i < size; i++)
-            getPatches()[offset + i] = reinterpret_cast<const u8*>(buffer)[i];
+        if (entry.offset + entry.size != offset || entry.size >= MaxCoalescedSize || now - entry.time > CoalesceTimeout)
+            return false;
+
+        this->m_undoMemoryUsage -= entry.getMemoryUsage(true);
+
+        entry.oldPatches.replace(offset, size, oldPatches);
+        entry.size += size;
+        entry.newPatches = this->m_patches.extract(entry.offset, entry.size);
+        entry.time = now;
+
+        this->m_undoMemoryUsage += entry.getMemoryUsage(true);
+
+        return true;
+    }
+
+    void Provider::trimUndoJournal() {
+        // Drop the oldest undo steps first and only then the redo steps so the journal stays contiguous.
+        // The most recent step is always kept so even edits larger than the limit can be undone
+        while (this->m_undoJournal.size() > 1 && this->m_undoMemoryUsage > this->m_undoMemoryLimit) {
+            if (this->m_undoPosition > 1) {
+                this->m_undoMemoryUsage -= this->m_undoJournal.front().getMemoryUsage(true);
+                this->m_undoJournal.pop_front();
+                this->m_undoPosition--;
+            } else {
+                this->m_undoMemoryUsage -= this->m_undoJournal.back().getMemoryUsage(false);
+                this->m_undoJournal.pop_back();
+            }
+        }
     }
 
     void Provider::undo() {
-        if (canUndo())
-            this->m_patchTreeOffset++;
+        if (!canUndo())
+            return;
+
+        auto &entry = this->m_undoJournal[--this->m_undoPosition];
+        this->m_patches.replace(entry.offset, entry.size, entry.oldPatches);
+
+        this->m_undoMemoryUsage -= entry.getMemoryUsage(true);
+        this->m_undoMemoryUsage += entry.getMemoryUsage(false);
     }
 
     void Provider::redo() {
-        if (canRedo())
-            this->m_patchTreeOffset--;
+        if (!canRedo())
+            return;
+
+        auto &entry = this->m_undoJournal[this->m_undoPosition++];
+        this->m_patches.replace(entry.offset, entry.size, entry.newPatches);
+
+        this->m_undoMemoryUsage -= entry.getMemoryUsage(false);
+        this->m_undoMemoryUsage += entry.getMemoryUsage(true);
     }
 
     bool Provider::canUndo() {
-        return this->m_patchTreeOffset < this->m_patches.size() - 1;
+        return this->m_undoPosition > 0;
     }
 
     bool Provider::canRedo() {
-        return this->m_patchTreeOffset > 0;
+        return this->m_undoPosition < this->m_undoJournal.size();
+    }
+
+    void Provider::setUndoMemoryLimit(size_t limit) {
+        this->m_undoMemoryLimit = limit;
+        this->trimUndoJournal();
+    }
+
+    size_t Provider::getUndoMemoryUsage() const {
+        return this->m_undoMemoryUsage;
     }
 
 }
\ No newline at end of file
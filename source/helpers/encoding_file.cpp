@@ -1,6 +1,5 @@
 #include "helpers/encoding_file.hpp"
 
-#include <ranges>
 #include <hex/helpers/utils.hpp>
 
 #include <fstream>
@@ -16,16 +15,41 @@ namespace hex {
         }
     }
 
-    std::pair<std::string_view, size_t> EncodingFile::getEncodingFor(const std::vector<u8> &buffer) const {
-        for (const auto &[size, mapping] : this->m_mapping | std::views::reverse) {
-            if (size > buffer.size()) continue;
+    std::pair<std::string_view, size_t> EncodingFile::getEncodingFor(std::span<const u8> buffer) const {
+        std::pair<std::string_view, size_t> result = { ".", 1 };
 
-            auto key = std::vector<u8>(buffer.begin(), buffer.begin() + size);
-            if (mapping.contains(key))
-                return { mapping.at(key), size };
+        u32 node = 0;
+        for (size_t i = 0; i < buffer.size() && i < this->m_longestSequence; i++) {
+            node = this->m_trie[node].children[buffer[i]];
+            if (node == NoEntry)
+                break;
+
+            if (auto value = this->m_trie[node].value; value.has_value())
+                result = { this->m_values[*value], i + 1 };
+        }
+
+        return result;
+    }
+
+    void EncodingFile::addMapping(const std::vector<u8> &from, const std::string &to) {
+        u32 node = 0;
+        for (u8 byte : from) {
+            if (this->m_trie[node].children[byte] == NoEntry) {
+                this->m_trie[node].children[byte] = this->m_trie.size();
+                this->m_trie.emplace_back();
+            }
+
+            node = this->m_trie[node].children[byte];
         }
 
-        return { ".", 1 };
+        // Keep the first mapping if a sequence shows up more than once
+        if (this->m_trie[node].value.has_value())
+            return;
+
+        this->m_trie[node].value = this->m_values.size();
+        this->m_values.push_back(to);
+
+        this->m_longestSequence = std::max(this->m_longestSequence, from.size());
     }
 
     void EncodingFile::parseThingyFile(std::ifstream &content) {
@@ -51,11 +75,7 @@ namespace hex {
             auto fromBytes = hex::parseByteString(from);
             if (fromBytes.empty()) continue;
 
-            if (!this->m_mapping.contains(fromBytes.size()))
-                this->m_mapping.insert({ fromBytes.size(), { } });
-            this->m_mapping[fromBytes.size()].insert({ fromBytes, to });
-
-            this->m_longestSequence = std::max(this->m_longestSequence, fromBytes.size());
+            this->addMapping(fromBytes, to);
         }
     }
 
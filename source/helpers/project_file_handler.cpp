@@ -40,6 +40,7 @@ namespace hex {
             ProjectFile::s_pattern              = projectFileData["pattern"];
             ProjectFile::s_patches              = projectFileData["patches"].get<Patches>();
             ProjectFile::s_dataProcessorContent = projectFileData["dataProcessor"];
+            ProjectFile::s_strings              = projectFileData.value("strings", "");
 
             for (auto &element : projectFileData["bookmarks"].items()) {
                 ProjectFile::s_bookmarks.push_back(element.value().get<ImHexApi::Bookmarks::Entry>());
@@ -69,6 +70,7 @@ namespace hex {
             projectFileData["pattern"]          = ProjectFile::s_pattern;
             projectFileData["patches"]          = ProjectFile::s_patches;
             projectFileData["dataProcessor"]    = ProjectFile::s_dataProcessorContent;
+            projectFileData["strings"]          = ProjectFile::s_strings;
 
             for (auto &bookmark : ProjectFile::s_bookmarks) {
                 projectFileData["bookmarks"].push_back(bookmark);
@@ -198,6 +198,11 @@ namespace hex::init {
     bool deleteSharedData() {
         SharedData::deferredCalls.clear();
 
+        // Views stop their background work on destruction, which may still be reading from the provider
+        for (auto &view : SharedData::views)
+            delete view;
+        SharedData::views.clear();
+
         delete SharedData::currentProvider;
         SharedData::currentProvider = nullptr;
 
@@ -207,10 +212,6 @@ namespace hex::init {
         SharedData::commandPaletteCommands.clear();
         SharedData::patternLanguageFunctions.clear();
 
-        for (auto &view : SharedData::views)
-            delete view;
-        SharedData::views.clear();
-
         SharedData::toolsEntries.clear();
 
         SharedData::dataInspectorEntries.clear();
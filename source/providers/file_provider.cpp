@@ -1,7 +1,11 @@
 #include "providers/file_provider.hpp"
 
+#include <algorithm>
 #include <ctime>
 #include <cstring>
+#include <filesystem>
+#include <limits>
+#include <utility>
 
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/file.hpp>
@@ -14,15 +18,24 @@ namespace hex::prv {
     }
 
     FileProvider::~FileProvider() {
+        {
+            std::scoped_lock lock(this->m_prefetchMutex);
+            this->m_stopPrefetching = true;
+        }
+        this->m_prefetchSignal.notify_one();
+
+        if (this->m_prefetchThread.joinable())
+            this->m_prefetchThread.join();
+
         this->close();
     }
 
 
     bool FileProvider::isAvailable() {
         #if defined(OS_WINDOWS)
-        return this->m_file != nullptr && this->m_mapping != nullptr && this->m_mappedFile != nullptr;
+        return this->m_file != nullptr && this->m_mapping != nullptr;
         #else
-        return this->m_file != -1 && this->m_mappedFile != nullptr;
+        return this->m_file != -1;
         #endif
     }
 
@@ -42,22 +55,95 @@ namespace hex::prv {
         return !this->getPatches().empty();
     }
 
+    bool FileProvider::isThreadSafe() {
+        // Reads copy from the mapped file and only take the mapping lock to find their window
+        return true;
+    }
+
 
     void FileProvider::read(u64 offset, void *buffer, size_t size, bool overlays) {
 
         if (((offset - this->getBaseAddress()) + size) > this->getSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset - this->getBaseAddress(), size);
+        this->readRaw(offset, buffer, size);
 
-        for (u64 i = 0; i < size; i++)
-            if (getPatches().contains(offset + i))
-                reinterpret_cast<u8*>(buffer)[i] = getPatches()[offset + PageSize * this->m_currPage + i];
+        auto &patches = this->getPatches();
+        if (!patches.empty()) {
+            patches.forEachInRange(offset, size, [&](u64 address, std::span<const u8> bytes) {
+                std::memcpy(static_cast<u8*>(buffer) + (address - offset), bytes.data(), bytes.size());
+            });
+        }
 
         if (overlays)
             this->applyOverlays(offset, buffer, size);
     }
 
+    std::future<void> FileProvider::readAsync(std::vector<ReadRequest> requests, bool overlays) {
+        // Have the kernel start paging in all requested ranges right away, copying them out happens on the prefetch worker
+        for (const auto &request : requests) {
+            if (request.offset < this->getBaseAddress())
+                continue;
+
+        #if defined(OS_LINUX)
+            ::posix_fadvise(this->m_file, request.offset - this->getBaseAddress(), request.size, POSIX_FADV_WILLNEED);
+        #elif defined(OS_MACOS)
+            radvisory advisory = { off_t(request.offset - this->getBaseAddress()), int(std::min<size_t>(request.size, std::numeric_limits<int>::max())) };
+            ::fcntl(this->m_file, F_RDADVISE, &advisory);
+        #endif
+        }
+
+        std::scoped_lock lock(this->m_prefetchMutex);
+
+        if (!this->m_prefetchThread.joinable())
+            this->m_prefetchThread = std::thread([this] { this->prefetchWorker(); });
+
+        auto &job = this->m_prefetchQueue.emplace_back(PrefetchJob { std::move(requests), overlays, { } });
+        auto future = job.done.get_future();
+
+        this->m_prefetchSignal.notify_one();
+
+        return future;
+    }
+
+    void FileProvider::prefetchWorker() {
+        std::unique_lock lock(this->m_prefetchMutex);
+
+        while (true) {
+            this->m_prefetchSignal.wait(lock, [this] { return this->m_stopPrefetching || !this->m_prefetchQueue.empty(); });
+
+            // Finish all queued jobs before stopping so nobody is left waiting on a future that never becomes ready
+            if (this->m_prefetchQueue.empty())
+                return;
+
+            auto job = std::move(this->m_prefetchQueue.front());
+            this->m_prefetchQueue.pop_front();
+
+            lock.unlock();
+            for (const auto &request : job.requests)
+                this->read(request.offset, request.buffer, request.size, job.overlays);
+            job.done.set_value();
+            lock.lock();
+        }
+    }
+
+    std::optional<MappedSpan> FileProvider::tryGetSpan(u64 offset, size_t size) {
+        if (offset < this->getBaseAddress() || ((offset - this->getBaseAddress()) + size) > this->getSize() || size == 0)
+            return std::nullopt;
+
+        if (this->getPatches().overlaps(offset, size) || this->hasOverlays(offset, size))
+            return std::nullopt;
+
+        std::scoped_lock lock(this->m_mappingMutex);
+
+        size_t available = 0;
+        auto data = this->getMappedData(offset - this->getBaseAddress(), available);
+        if (data == nullptr || available < size)
+            return std::nullopt;
+
+        return MappedSpan { std::span<const u8>(data, size), this->m_mappedWindows.front().data };
+    }
+
     void FileProvider::write(u64 offset, const void *buffer, size_t size) {
         if (((offset - this->getBaseAddress()) + size) > this->getSize() || buffer == nullptr || size == 0)
             return;
@@ -71,38 +157,216 @@ namespace hex::prv {
         if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset, size);
+        auto bytes = static_cast<u8*>(buffer);
+        while (size > 0) {
+            size_t available = 0;
+            std::shared_ptr<u8> window;
+            u8 *data;
+            {
+                // Only look the window up under the lock, the reference taken keeps it mapped while copying
+                std::scoped_lock lock(this->m_mappingMutex);
+
+                data = this->getMappedData(offset, available);
+                if (data == nullptr)
+                    return;
+
+                window = this->m_mappedWindows.front().data;
+            }
+
+            available = std::min(available, size);
+            std::memcpy(bytes, data, available);
+
+            offset += available;
+            bytes += available;
+            size -= available;
+        }
     }
 
     void FileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         offset -= this->getBaseAddress();
 
-        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0 || !this->m_writable)
             return;
 
-        std::memcpy(reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset, buffer, size);
+        auto bytes = static_cast<const u8*>(buffer);
+        while (size > 0) {
+            size_t available = 0;
+            std::shared_ptr<u8> window;
+            u8 *data;
+            {
+                std::scoped_lock lock(this->m_mappingMutex);
+
+                data = this->getMappedData(offset, available);
+                if (data == nullptr)
+                    return;
+
+                window = this->m_mappedWindows.front().data;
+            }
+
+            available = std::min(available, size);
+            std::memcpy(data, bytes, available);
+
+            offset += available;
+            bytes += available;
+            size -= available;
+        }
+    }
+
+    u8* FileProvider::getMappedData(u64 offset, size_t &available) {
+        const u64 windowOffset = offset - (offset % WindowSize);
+
+        auto window = std::find_if(this->m_mappedWindows.begin(), this->m_mappedWindows.end(), [&](const MappedWindow &window) {
+            return window.offset == windowOffset;
+        });
+
+        if (window != this->m_mappedWindows.end()) {
+            // Keep the most recently used window at the front
+            this->m_mappedWindows.splice(this->m_mappedWindows.begin(), this->m_mappedWindows, window);
+        } else {
+            const size_t windowSize = std::min<u64>(WindowSize, this->m_fileSize - windowOffset);
+
+        #if defined(OS_WINDOWS)
+            auto data = ::MapViewOfFile(this->m_mapping, this->m_writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, DWORD(windowOffset >> 32), DWORD(windowOffset & 0xFFFF'FFFF), windowSize);
+            if (data == nullptr)
+                return nullptr;
+
+            // Spans handed out by tryGetSpan share ownership so a window is only unmapped once nobody uses it anymore
+            std::shared_ptr<u8> mapping(static_cast<u8*>(data), [](u8 *data) { ::UnmapViewOfFile(data); });
+        #else
+            auto data = ::mmap(nullptr, windowSize, this->m_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, this->m_file, windowOffset);
+            if (data == MAP_FAILED)
+                return nullptr;
+
+            // Let the kernel read ahead aggressively while the file is being walked front to back
+            if (this->m_lastWindowOffset.has_value() && *this->m_lastWindowOffset + WindowSize == windowOffset) {
+                ::madvise(data, windowSize, MADV_SEQUENTIAL);
+                ::madvise(data, windowSize, MADV_WILLNEED);
+            }
+
+            std::shared_ptr<u8> mapping(static_cast<u8*>(data), [windowSize](u8 *data) { ::munmap(data, windowSize); });
+        #endif
+
+            this->m_lastWindowOffset = windowOffset;
+            this->m_mappedWindows.push_front(MappedWindow { windowOffset, windowSize, std::move(mapping) });
+
+            while (this->m_mappedWindows.size() > MaxMappedWindows)
+                this->m_mappedWindows.pop_back();
+        }
+
+        auto &mapped = this->m_mappedWindows.front();
+        available = mapped.size - (offset - mapped.offset);
+
+        return mapped.data.get() + (offset - mapped.offset);
+    }
+
+    void FileProvider::unmapAllWindows() {
+        std::scoped_lock lock(this->m_mappingMutex);
+
+        this->m_mappedWindows.clear();
+        this->m_lastWindowOffset.reset();
     }
 
     void FileProvider::save() {
         this->applyPatches();
     }
 
-    void FileProvider::saveAs(const std::string &path) {
-        File file(path, File::Mode::Create);
+    void FileProvider::saveAs(const std::string &path, const DataSnapshot &snapshot, const ProgressCallback &progress) {
+        constexpr static size_t ChunkSize = 0x100'0000;
 
-        if (file.isValid()) {
-            std::vector<u8> buffer(std::min<size_t>(0xFF'FFFF, file.getSize()), 0x00);
-            size_t bufferSize = buffer.size();
+        const u64 baseAddress = this->getBaseAddress();
+        const u64 size = this->getActualSize();
 
-            auto provider = SharedData::currentProvider;
-            for (u64 offset = 0; offset < provider->getActualSize(); offset += bufferSize) {
-                if (bufferSize > provider->getActualSize() - offset)
-                    bufferSize = provider->getActualSize() - offset;
+        // Only patched and overlaid ranges differ from the file on disk, everything in between is copied over as is
+        std::vector<std::pair<u64, u64>> modifiedRanges;
+        auto addModifiedRange = [&](u64 address, u64 rangeSize) {
+            u64 from = std::clamp<u64>(address, baseAddress, baseAddress + size) - baseAddress;
+            u64 to = std::clamp<u64>(address + rangeSize, baseAddress, baseAddress + size) - baseAddress;
 
-                provider->readRelative(offset, buffer.data(), bufferSize);
-                file.write(buffer);
+            if (from >= to)
+                return;
+
+            if (!modifiedRanges.empty() && modifiedRanges.back().second >= from)
+                modifiedRanges.back().second = std::max(modifiedRanges.back().second, to);
+            else
+                modifiedRanges.emplace_back(from, to);
+        };
+
+        snapshot.patches.forEach([&](u64 address, std::span<const u8> bytes) {
+            addModifiedRange(address, bytes.size());
+        });
+
+        if (!snapshot.overlays.empty()) {
+            std::vector<std::pair<u64, u64>> overlayRanges;
+            for (const auto &[address, data] : snapshot.overlays)
+                overlayRanges.emplace_back(address, data.size());
+
+            for (const auto &[from, to] : std::exchange(modifiedRanges, { }))
+                overlayRanges.emplace_back(baseAddress + from, to - from);
+
+            std::sort(overlayRanges.begin(), overlayRanges.end());
+            for (const auto &[address, rangeSize] : overlayRanges)
+                addModifiedRange(address, rangeSize);
+        }
+
+        bool cancelled = false;
+
+        {
+            File file(path, File::Mode::Create);
+            if (!file.isValid())
+                return;
+
+            u64 processed = 0;
+            auto reportProgress = [&](u64 bytes) {
+                processed += bytes;
+                if (progress && !progress(processed, size))
+                    cancelled = true;
+            };
+
+            std::vector<u8> buffer;
+            auto copyBuffered = [&](u64 from, u64 to) {
+                for (u64 offset = from; offset < to && !cancelled; offset += ChunkSize) {
+                    size_t chunkSize = std::min<u64>(ChunkSize, to - offset);
+
+                    buffer.resize(chunkSize);
+                    this->readRaw(baseAddress + offset, buffer.data(), chunkSize);
+                    snapshot.apply(baseAddress + offset, buffer.data(), chunkSize);
+
+                    file.seek(offset);
+                    file.write(buffer.data(), chunkSize);
+
+                    reportProgress(chunkSize);
+                }
+            };
+
+            auto copyUnmodified = [&](u64 from, u64 to) {
+            #if defined(OS_LINUX)
+                // Let the kernel copy unmodified data without it passing through user space. Filesystems supporting reflinks share the blocks instead
+                std::fflush(file.getHandle());
+                while (from < to && !cancelled) {
+                    loff_t inputOffset = from, outputOffset = from;
+                    auto copied = ::copy_file_range(this->m_file, &inputOffset, ::fileno(file.getHandle()), &outputOffset, std::min<u64>(ChunkSize, to - from), 0);
+                    if (copied <= 0)
+                        break;
+
+                    from += copied;
+                    reportProgress(copied);
+                }
+            #endif
+
+                copyBuffered(from, to);
+            };
+
+            u64 offset = 0;
+            for (const auto &[from, to] : modifiedRanges) {
+                copyUnmodified(offset, from);
+                copyBuffered(from, to);
+                offset = to;
             }
+            copyUnmodified(offset, size);
         }
+
+        if (cancelled)
+            std::filesystem::remove(path);
     }
 
     void FileProvider::resize(ssize_t newSize) {
@@ -207,12 +471,6 @@ namespace hex::prv {
             CloseHandle(this->m_mapping);
         };
 
-        this->m_mappedFile = MapViewOfFile(this->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, this->m_fileSize);
-        if (this->m_mappedFile == nullptr) {
-            this->m_readable = false;
-            return;
-        }
-
         fileCleanup.release();
         mappingCleanup.release();
 
@@ -232,21 +490,18 @@ namespace hex::prv {
 
             this->m_fileSize = this->m_fileStats.st_size;
 
-            this->m_mappedFile = mmap(nullptr, this->m_fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, this->m_file, 0);
-
     #endif
     }
 
     void FileProvider::close() {
+        this->unmapAllWindows();
+
     #if defined(OS_WINDOWS)
-        if (this->m_mappedFile != nullptr)
-            ::UnmapViewOfFile(this->m_mappedFile);
         if (this->m_mapping != nullptr)
             ::CloseHandle(this->m_mapping);
         if (this->m_file != nullptr)
             ::CloseHandle(this->m_file);
     #else
-        ::munmap(this->m_mappedFile, this->m_fileSize);
         ::close(this->m_file);
     #endif
     }
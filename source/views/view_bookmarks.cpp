@@ -28,10 +28,13 @@ namespace hex {
 
             SharedData::bookmarkEntries.push_back(bookmark);
             ProjectFile::markDirty();
+
+            EventManager::post<EventBookmarksChanged>();
         });
 
         EventManager::subscribe<EventProjectFileLoad>(this, []{
             SharedData::bookmarkEntries = ProjectFile::getBookmarks();
+            EventManager::post<EventBookmarksChanged>();
         });
 
         EventManager::subscribe<EventProjectFileStore>(this, []{
@@ -138,8 +141,10 @@ namespace hex {
                         ImGui::TextUnformatted("hex.view.bookmarks.header.name"_lang);
                         ImGui::Separator();
 
-                        ImGui::ColorEdit4("hex.view.bookmarks.header.color"_lang, (float*)&headerColor.Value, ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel | ImGuiColorEditFlags_NoAlpha | (locked ? ImGuiColorEditFlags_NoPicker : ImGuiColorEditFlags_None));
-                        color = headerColor;
+                        if (ImGui::ColorEdit4("hex.view.bookmarks.header.color"_lang, (float*)&headerColor.Value, ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel | ImGuiColorEditFlags_NoAlpha | (locked ? ImGuiColorEditFlags_NoPicker : ImGuiColorEditFlags_None))) {
+                            color = headerColor;
+                            EventManager::post<EventBookmarksChanged>();
+                        }
                         ImGui::SameLine();
 
                         if (locked)
@@ -167,6 +172,8 @@ namespace hex {
                 if (bookmarkToRemove != bookmarks.end()) {
                     bookmarks.erase(bookmarkToRemove);
                     ProjectFile::markDirty();
+
+                    EventManager::post<EventBookmarksChanged>();
                 }
 
             }
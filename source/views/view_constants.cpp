@@ -3,9 +3,13 @@
 #include <hex/helpers/paths.hpp>
 #include <hex/helpers/logger.hpp>
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/providers/provider.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <map>
 #include <nlohmann/json.hpp>
 
 namespace hex {
@@ -15,10 +19,112 @@ namespace hex {
 
         this->m_filter.reserve(0xFFFF);
         std::memset(this->m_filter.data(), 0x00, this->m_filter.capacity());
+
+        EventManager::subscribe<EventFileUnloaded>(this, [this] {
+            this->m_search.cancel();
+            this->m_searchResultsPending = false;
+
+            for (auto &constant : this->m_constants) {
+                constant.occurrences = 0;
+                constant.firstOccurrence.reset();
+            }
+        });
     }
 
     ViewConstants::~ViewConstants() {
+        EventManager::unsubscribe<EventFileUnloaded>(this);
+    }
+
+    /* Returns the bytes a constant is stored as in memory */
+    static std::optional<std::vector<u8>> getConstantBytes(const Constant &constant) {
+        try {
+            std::vector<u8> bytes;
+
+            if (constant.type == ConstantType::Int10) {
+                u64 value = std::stoll(constant.value, nullptr, 10);
+
+                size_t size = 1;
+                while (size < sizeof(u64) && (value >> (size * 8)) != 0)
+                    size *= 2;
+
+                for (size_t i = 0; i < size; i++)
+                    bytes.push_back(value >> (i * 8));
+            } else {
+                auto digits = constant.value;
+                if (digits.starts_with("0x") || digits.starts_with("0X"))
+                    digits = digits.substr(2);
+                if ((digits.size() % 2) == 1)
+                    digits = "0" + digits;
+
+                for (size_t i = 0; i < digits.size(); i += 2)
+                    bytes.push_back(std::stoul(digits.substr(i, 2), nullptr, 16));
+
+                if (constant.type == ConstantType::Int16LittleEndian)
+                    std::reverse(bytes.begin(), bytes.end());
+            }
+
+            return bytes;
+        } catch (std::exception &) {
+            return std::nullopt;
+        }
+    }
+
+    void ViewConstants::searchConstants() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr)
+            return;
+
+        this->m_search.cancel();
+
+        // Constants that share a value are searched for once
+        std::map<std::vector<u8>, u32> indices;
+        for (const auto &constant : this->m_constants) {
+            auto bytes = getConstantBytes(constant);
+            if (bytes.has_value() && !bytes->empty())
+                indices.emplace(std::move(*bytes), indices.size());
+        }
+
+        this->m_searchSequences.resize(indices.size());
+        for (auto &[bytes, index] : indices)
+            this->m_searchSequences[index] = bytes;
 
+        this->m_searchOccurrences.assign(this->m_searchSequences.size(), { 0, 0 });
+        this->m_searchResultsPending = true;
+
+        search::MultiSequenceMatcher matcher(this->m_searchSequences);
+        const size_t maxSize = matcher.getMaxSize();
+
+        // Occurrences are only counted, they're read by the UI thread once the search has finished
+        this->m_search.start(provider, provider->getBaseAddress(), provider->getSize(), [this, matcher = std::move(matcher)](u64 address, std::span<const u8> data, size_t startLimit, std::vector<Region> &) {
+            matcher.find(data, startLimit, [&, this](size_t offset, u32 index) {
+                auto &occurrences = this->m_searchOccurrences[index];
+
+                if (occurrences.count++ == 0)
+                    occurrences.firstAddress = address + offset;
+            });
+        }, maxSize);
+    }
+
+    void ViewConstants::applySearchResults() {
+        std::map<std::vector<u8>, Occurrences> occurrences;
+        for (u32 i = 0; i < this->m_searchSequences.size(); i++)
+            occurrences.emplace(this->m_searchSequences[i], this->m_searchOccurrences[i]);
+
+        for (auto &constant : this->m_constants) {
+            constant.occurrences = 0;
+            constant.firstOccurrence.reset();
+
+            auto bytes = getConstantBytes(constant);
+            if (!bytes.has_value())
+                continue;
+
+            if (auto it = occurrences.find(*bytes); it != occurrences.end() && it->second.count > 0) {
+                constant.occurrences = it->second.count;
+                constant.firstOccurrence = it->second.firstAddress;
+            }
+        }
+
+        this->m_searchResultsPending = false;
     }
 
     void ViewConstants::reloadConstants() {
@@ -65,7 +171,22 @@ namespace hex {
     }
 
     void ViewConstants::drawContent() {
+        // Also applied while the window is collapsed, otherwise the pending results would keep requesting new frames
+        if (this->m_searchResultsPending && !this->m_search.isRunning())
+            this->applySearchResults();
+
         if (ImGui::Begin(View::toWindowName("hex.view.constants.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            if (this->m_search.isRunning()) {
+                ImGui::ProgressBar(this->m_search.getProgress(), ImVec2(200, 0));
+            } else {
+                ImGui::Disabled([this] {
+                    if (ImGui::Button("hex.view.constants.search"_lang))
+                        this->searchConstants();
+                }, SharedData::currentProvider == nullptr || !SharedData::currentProvider->isReadable());
+            }
+
+            ImGui::SameLine();
+
 
             ImGui::InputText("##search", this->m_filter.data(), this->m_filter.capacity(), ImGuiInputTextFlags_CallbackEdit, [](ImGuiInputTextCallbackData *data) {
                 auto &view = *static_cast<ViewConstants*>(data->UserData);
@@ -84,7 +205,7 @@ namespace hex {
                 return 0;
                 }, this);
 
-            if (ImGui::BeginTable("##strings", 4,
+            if (ImGui::BeginTable("##strings", 5,
                                   ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable |
                                   ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                 ImGui::TableSetupScrollFreeze(0, 1);
@@ -92,6 +213,7 @@ namespace hex {
                 ImGui::TableSetupColumn("hex.view.constants.row.name"_lang, 0, -1, ImGui::GetID("name"));
                 ImGui::TableSetupColumn("hex.view.constants.row.desc"_lang, 0, -1, ImGui::GetID("desc"));
                 ImGui::TableSetupColumn("hex.view.constants.row.value"_lang, 0, -1, ImGui::GetID("value"));
+                ImGui::TableSetupColumn("hex.view.constants.row.occurrences"_lang, 0, -1, ImGui::GetID("occurrences"));
 
                 auto sortSpecs = ImGui::TableGetSortSpecs();
 
@@ -118,6 +240,11 @@ namespace hex {
                                 return left.value > right.value;
                             else
                                 return left.value < right.value;
+                        } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("occurrences")) {
+                            if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
+                                return left.occurrences > right.occurrences;
+                            else
+                                return left.occurrences < right.occurrences;
                         }
 
                         return false;
@@ -143,6 +270,13 @@ namespace hex {
                         ImGui::Text("%s", constant.description.c_str());
                         ImGui::TableNextColumn();
                         ImGui::Text("%s", constant.value.c_str());
+                        ImGui::TableNextColumn();
+                        if (constant.firstOccurrence.has_value()) {
+                            ImGui::PushID(i);
+                            if (ImGui::Selectable(hex::format("{}", constant.occurrences).c_str()))
+                                EventManager::post<RequestSelectionChange>(Region { *constant.firstOccurrence, getConstantBytes(constant)->size() });
+                            ImGui::PopID();
+                        }
                     }
                 }
                 clipper.End();
@@ -29,10 +29,15 @@ namespace hex {
 
             this->m_shouldInvalidate = true;
         });
+
+        EventManager::subscribe<EventDataChanged>(this, [this]() {
+            this->m_shouldInvalidate = true;
+        });
     }
 
     ViewDataInspector::~ViewDataInspector() {
         EventManager::unsubscribe<EventRegionSelected>(this);
+        EventManager::unsubscribe<EventDataChanged>(this);
     }
 
     void ViewDataInspector::drawContent() {
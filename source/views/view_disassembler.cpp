@@ -8,6 +8,8 @@
 
 #include <imgui_imhex_extensions.h>
 
+#include <GLFW/glfw3.h>
+
 using namespace std::literals::string_literals;
 
 namespace hex {
@@ -94,6 +96,9 @@ namespace hex {
             }
 
             this->m_disassembling = false;
+
+            // Wake up the main loop so the disassembly gets drawn
+            glfwPostEmptyEvent();
         }).detach();
 
     }
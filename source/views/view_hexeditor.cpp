@@ -4,6 +4,7 @@
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/crypto.hpp>
 #include <hex/helpers/file.hpp>
+#include <hex/helpers/literals.hpp>
 #include <hex/pattern_language/pattern_data.hpp>
 
 #include "providers/file_provider.hpp"
@@ -18,7 +19,11 @@
 #undef __STRICT_ANSI__
 #include <cstdio>
 
+#include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <set>
+#include <thread>
 
 #if defined(OS_WINDOWS)
     #include <windows.h>
@@ -29,20 +34,21 @@
 
 namespace hex {
 
+    using namespace hex::literals;
+
     ViewHexEditor::ViewHexEditor() : View("hex.view.hexeditor.name"_lang) {
 
         this->m_searchStringBuffer.resize(0xFFF, 0x00);
         this->m_searchHexBuffer.resize(0xFFF, 0x00);
 
-        this->m_memoryEditor.ReadFn = [](const ImU8 *data, size_t off) -> ImU8 {
+        this->m_memoryEditor.ReadFn = [](const ImU8 *data, size_t off, ImU8 *buffer, size_t size) {
             auto provider = SharedData::currentProvider;
-            if (!provider->isAvailable() || !provider->isReadable())
-                return 0x00;
-
-            ImU8 byte;
-            provider->readRelative(off, &byte, sizeof(ImU8));
+            if (!provider->isAvailable() || !provider->isReadable()) {
+                std::memset(buffer, 0x00, size);
+                return;
+            }
 
-            return byte;
+            provider->readRelative(provider->getCurrentPageOffset() + off, buffer, size);
         };
 
         this->m_memoryEditor.WriteFn = [](ImU8 *data, size_t off, ImU8 d) -> void {
@@ -50,53 +56,32 @@ namespace hex {
             if (!provider->isAvailable() || !provider->isWritable())
                 return;
 
-            provider->writeRelative(off, &d, sizeof(ImU8));
+            provider->writeRelative(provider->getCurrentPageOffset() + off, &d, sizeof(ImU8));
             EventManager::post<EventDataChanged>();
             ProjectFile::markDirty();
         };
 
-        this->m_memoryEditor.HighlightFn = [](const ImU8 *data, size_t off, bool next) -> bool {
+        this->m_memoryEditor.HighlightFn = [](const ImU8 *data, size_t off, ImU32 *colors, size_t size) {
             ViewHexEditor *_this = (ViewHexEditor *) data;
 
-            std::optional<u32> currColor, prevColor;
-
-            off += SharedData::currentProvider->getBaseAddress();
-
-            u32 alpha = static_cast<u32>(_this->m_highlightAlpha) << 24;
-
-            for (const auto &[region, name, comment, color, locked] : ImHexApi::Bookmarks::getEntries()) {
-                if (off >= region.address && off < (region.address + region.size))
-                    currColor = (color & 0x00FFFFFF) | alpha;
-                if ((off - 1) >= region.address && (off - 1) < (region.address + region.size))
-                    prevColor = (color & 0x00FFFFFF) | alpha;
-            }
+            const u64 start = off + SharedData::currentProvider->getBaseAddress() + SharedData::currentProvider->getCurrentPageOffset();
+            const u64 end = start + size;
 
-            if (_this->m_highlightedBytes.contains(off)) {
-                auto color = (_this->m_highlightedBytes[off] & 0x00FFFFFF) | alpha;
-                currColor = currColor.has_value() ? ImAlphaBlendColors(color, currColor.value()) : color;
-            }
-            if (_this->m_highlightedBytes.contains(off - 1)) {
-                auto color = (_this->m_highlightedBytes[off - 1] & 0x00FFFFFF) | alpha;
-                prevColor = prevColor.has_value() ? ImAlphaBlendColors(color, prevColor.value()) : color;
-            }
+            auto &runs = _this->m_highlights;
+            auto run = std::upper_bound(runs.begin(), runs.end(), start, [](u64 address, const HighlightRun &run) { return address < run.end(); });
 
-            if (next && prevColor != currColor) {
-                return false;
-            }
+            for (; run != runs.end() && run->address < end; ++run) {
+                u64 from = std::max(run->address, start);
+                u64 to = std::min(run->end(), end);
 
-            if (currColor.has_value() && (currColor.value() & 0x00FFFFFF) != 0x00) {
-                _this->m_memoryEditor.HighlightColor = (currColor.value() & 0x00FFFFFF) | alpha;
-                return true;
+                std::fill(colors + (from - start), colors + (to - start), run->color);
             }
-
-            _this->m_memoryEditor.HighlightColor = 0x60C08080;
-            return false;
         };
 
         this->m_memoryEditor.HoverFn = [](const ImU8 *data, size_t off) {
             bool tooltipShown = false;
 
-            off += SharedData::currentProvider->getBaseAddress();
+            off += SharedData::currentProvider->getBaseAddress() + SharedData::currentProvider->getCurrentPageOffset();
 
             for (const auto &[region, name, comment, color, locked] : ImHexApi::Bookmarks::getEntries()) {
                 if (off >= region.address && off < (region.address + region.size)) {
@@ -114,19 +99,13 @@ namespace hex {
                 ImGui::EndTooltip();
         };
 
-        this->m_memoryEditor.DecodeFn = [](const ImU8 *data, size_t addr) -> MemoryEditor::DecodeData {
+        this->m_memoryEditor.DecodeFn = [](const ImU8 *data, size_t addr, const ImU8 *bytes, size_t size) -> MemoryEditor::DecodeData {
             ViewHexEditor *_this = (ViewHexEditor *) data;
 
             if (_this->m_currEncodingFile.getLongestSequence() == 0)
                 return { ".", 1, 0xFFFF8000 };
 
-            auto &provider = SharedData::currentProvider;
-            size_t size = std::min<size_t>(_this->m_currEncodingFile.getLongestSequence(), provider->getActualSize() - addr);
-
-            std::vector<u8> buffer(size);
-            provider->readRelative(addr, buffer.data(), size);
-
-            auto [decoded, advance] = _this->m_currEncodingFile.getEncodingFor(buffer);
+            auto [decoded, advance] = _this->m_currEncodingFile.getEncodingFor({ bytes, size });
 
             ImColor color;
             if (decoded.length() == 1 && std::isalnum(decoded[0])) color = 0xFFFF8000;
@@ -138,6 +117,8 @@ namespace hex {
             return { std::string(decoded), advance, color };
         };
 
+        this->m_memoryEditor.HighlightColor = 0x60C08080;
+
         EventManager::subscribe<RequestOpenFile>(this, [this](const std::string &filePath) {
             this->openFile(filePath);
             this->getWindowOpenState() = true;
@@ -153,10 +134,11 @@ namespace hex {
             if (region.size != 0) {
                 provider->setCurrentPage(page.value());
                 u64 start = region.address;
-                this->m_memoryEditor.GotoAddrAndSelect(start - provider->getBaseAddress(), start + region.size - provider->getBaseAddress() - 1);
+                u64 pageAddress = provider->getBaseAddress() + provider->getCurrentPageOffset();
+                this->m_memoryEditor.GotoAddrAndSelect(start - pageAddress, start + region.size - pageAddress - 1);
             }
 
-            EventManager::post<EventRegionSelected>(Region { this->m_memoryEditor.DataPreviewAddr, (this->m_memoryEditor.DataPreviewAddrEnd - this->m_memoryEditor.DataPreviewAddr) + 1});
+            EventManager::post<EventRegionSelected>(this->getSelection());
         });
 
         EventManager::subscribe<EventProjectFileLoad>(this, []() {
@@ -171,11 +153,22 @@ namespace hex {
         });
 
         EventManager::subscribe<EventPatternChanged>(this, [this]() {
-            this->m_highlightedBytes.clear();
+            std::vector<pl::HighlightInterval> intervals;
 
-            for (const auto &pattern : SharedData::patternData) {
-                this->m_highlightedBytes.merge(pattern->getHighlightedAddresses());
-            }
+            for (const auto &pattern : SharedData::patternData)
+                pattern->getHighlightedIntervals(intervals);
+
+            std::vector<HighlightRun> runs;
+            runs.reserve(intervals.size());
+            for (const auto &[offset, size, color] : intervals)
+                runs.push_back({ offset, size, color });
+
+            this->m_patternHighlights = flattenHighlightRuns(runs, false);
+            this->rebuildHighlights();
+        });
+
+        EventManager::subscribe<EventBookmarksChanged>(this, [this]() {
+            this->rebuildHighlights();
         });
 
         EventManager::subscribe<RequestOpenWindow>(this, [this](std::string name) {
@@ -194,6 +187,10 @@ namespace hex {
                     EventManager::post<RequestOpenFile>(path);
                     this->getWindowOpenState() = true;
                 });
+            } else if (name == "Save File As") {
+                hex::openFileBrowser("hex.view.hexeditor.save_as"_lang, DialogMode::Save, { }, [this](auto path) {
+                    this->saveFileAs(path);
+                });
             } else if (name == "Open Project") {
                 hex::openFileBrowser("hex.view.hexeditor.open_project"_lang, DialogMode::Open, { { "Project File", "hexproj" } }, [this](auto path) {
                     ProjectFile::load(path);
@@ -206,15 +203,23 @@ namespace hex {
         EventManager::subscribe<EventSettingsChanged>(this, [this] {
             auto alpha = ContentRegistry::Settings::getSetting("hex.builtin.setting.interface", "hex.builtin.setting.interface.highlight_alpha");
 
-            if (alpha.is_number())
+            if (alpha.is_number()) {
                 this->m_highlightAlpha = alpha;
+                this->rebuildHighlights();
+            }
+
+            auto undoLimit = ContentRegistry::Settings::getSetting("hex.builtin.setting.general", "hex.builtin.setting.general.undo_memory_limit");
+
+            if (undoLimit.is_number()) {
+                this->m_undoMemoryLimit = undoLimit.get<size_t>() * 1_MiB;
+
+                if (SharedData::currentProvider != nullptr)
+                    SharedData::currentProvider->setUndoMemoryLimit(this->m_undoMemoryLimit);
+            }
         });
 
         EventManager::subscribe<QuerySelection>(this, [this](auto &region) {
-            u64 address = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-            size_t size = std::abs(s64(this->m_memoryEditor.DataPreviewAddrEnd) - s64(this->m_memoryEditor.DataPreviewAddr)) + 1;
-
-            region = Region { address, size };
+            region = this->getSelection();
         });
     }
 
@@ -224,16 +229,146 @@ namespace hex {
         EventManager::unsubscribe<EventProjectFileLoad>(this);
         EventManager::unsubscribe<EventWindowClosing>(this);
         EventManager::unsubscribe<EventPatternChanged>(this);
+        EventManager::unsubscribe<EventBookmarksChanged>(this);
         EventManager::unsubscribe<RequestOpenWindow>(this);
         EventManager::unsubscribe<EventSettingsChanged>(this);
+
+        this->cancelSaving();
+    }
+
+    Region ViewHexEditor::getSelection() const {
+        auto provider = SharedData::currentProvider;
+
+        if (provider == nullptr || this->m_memoryEditor.DataPreviewAddr == size_t(-1) || this->m_memoryEditor.DataPreviewAddrEnd == size_t(-1))
+            return { u64(-1), 0 };
+
+        u64 start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        u64 end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+
+        return { provider->getBaseAddress() + provider->getCurrentPageOffset() + start, (end - start) + 1 };
+    }
+
+    void ViewHexEditor::appendHighlightRun(std::vector<HighlightRun> &runs, u64 from, u64 to, u32 color) {
+        if (!runs.empty() && runs.back().end() == from && runs.back().color == color)
+            runs.back().size += to - from;
+        else
+            runs.push_back({ from, to - from, color });
+    }
+
+    std::vector<ViewHexEditor::HighlightRun> ViewHexEditor::flattenHighlightRuns(const std::vector<HighlightRun> &runs, bool newestOnTop) {
+        struct Boundary {
+            u64 address;
+            u32 index;
+            bool start;
+        };
+
+        std::vector<Boundary> boundaries;
+        boundaries.reserve(runs.size() * 2);
+        for (u32 index = 0; index < runs.size(); index++) {
+            if (runs[index].size == 0) continue;
+
+            boundaries.push_back({ runs[index].address, index, true });
+            boundaries.push_back({ runs[index].end(), index, false });
+        }
+
+        std::sort(boundaries.begin(), boundaries.end(), [](const auto &left, const auto &right) { return left.address < right.address; });
+
+        // Sweep over all boundaries and color every segment with the topmost run covering it
+        std::vector<HighlightRun> result;
+        std::set<u32> active;
+        u64 prevAddress = 0;
+        for (size_t i = 0; i < boundaries.size();) {
+            const u64 address = boundaries[i].address;
+
+            if (!active.empty() && address > prevAddress)
+                appendHighlightRun(result, prevAddress, address, runs[newestOnTop ? *active.rbegin() : *active.begin()].color);
+
+            for (; i < boundaries.size() && boundaries[i].address == address; i++) {
+                if (boundaries[i].start)
+                    active.insert(boundaries[i].index);
+                else
+                    active.erase(boundaries[i].index);
+            }
+
+            prevAddress = address;
+        }
+
+        return result;
+    }
+
+    void ViewHexEditor::rebuildHighlights() {
+        const u32 alpha = static_cast<u32>(this->m_highlightAlpha) << 24;
+
+        // Bookmarks added later are drawn on top of earlier ones
+        std::vector<HighlightRun> bookmarkRuns;
+        for (const auto &[region, name, comment, color, locked] : ImHexApi::Bookmarks::getEntries())
+            bookmarkRuns.push_back({ region.address, region.size, (color & 0x00FFFFFF) | alpha });
+        bookmarkRuns = flattenHighlightRuns(bookmarkRuns, true);
+
+        // Pattern colors are blended over the bookmark colors where both overlap
+        std::vector<u64> points;
+        points.reserve((bookmarkRuns.size() + this->m_patternHighlights.size()) * 2);
+        for (const auto &runs : { std::cref(bookmarkRuns), std::cref(this->m_patternHighlights) }) {
+            for (const auto &run : runs.get()) {
+                points.push_back(run.address);
+                points.push_back(run.end());
+            }
+        }
+
+        std::sort(points.begin(), points.end());
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+
+        this->m_highlights.clear();
+
+        auto bookmark = bookmarkRuns.begin();
+        auto pattern = this->m_patternHighlights.begin();
+        for (size_t i = 0; i + 1 < points.size(); i++) {
+            const u64 from = points[i], to = points[i + 1];
+
+            while (bookmark != bookmarkRuns.end() && bookmark->end() <= from) ++bookmark;
+            while (pattern != this->m_patternHighlights.end() && pattern->end() <= from) ++pattern;
+
+            bool hasBookmark = bookmark != bookmarkRuns.end() && bookmark->address <= from;
+            bool hasPattern = pattern != this->m_patternHighlights.end() && pattern->address <= from;
+
+            u32 color;
+            if (hasBookmark && hasPattern)
+                color = ImAlphaBlendColors((pattern->color & 0x00FFFFFF) | alpha, bookmark->color);
+            else if (hasBookmark)
+                color = bookmark->color;
+            else if (hasPattern)
+                color = pattern->color;
+            else
+                continue;
+
+            if ((color & 0x00FFFFFF) == 0x00)
+                continue;
+
+            appendHighlightRun(this->m_highlights, from, to, (color & 0x00FFFFFF) | alpha);
+        }
+    }
+
+    static void selectSearchResult(const Region &result) {
+        EventManager::post<RequestSelectionChange>(result);
     }
 
     void ViewHexEditor::drawContent() {
         auto provider = SharedData::currentProvider;
 
-        size_t dataSize = (provider == nullptr || !provider->isReadable()) ? 0x00 : provider->getSize();
+        size_t dataSize = (provider == nullptr || !provider->isReadable()) ? 0x00 : provider->getCurrentPageSize();
+
+        // Done outside of the search popup so a search that finishes after the popup got closed is still handled
+        if (this->m_selectFirstSearchResult && this->m_currSearch != nullptr) {
+            const bool finished = !this->m_currSearch->isRunning();
+
+            if (auto result = this->m_currSearch->getResult(0); result.has_value()) {
+                this->m_selectFirstSearchResult = false;
+                selectSearchResult(*result);
+            } else if (finished)
+                this->m_selectFirstSearchResult = false;
+        }
 
-        this->m_memoryEditor.DrawWindow(View::toWindowName("hex.view.hexeditor.name").c_str(), &this->getWindowOpenState(), this, dataSize, dataSize == 0 ? 0x00 : provider->getBaseAddress());
+        this->m_memoryEditor.DrawWindow(View::toWindowName("hex.view.hexeditor.name").c_str(), &this->getWindowOpenState(), this, dataSize, dataSize == 0 ? 0x00 : provider->getBaseAddress() + provider->getCurrentPageOffset());
 
         if (dataSize != 0x00) {
             if (ImGui::Begin(View::toWindowName("hex.view.hexeditor.name").c_str())) {
@@ -255,7 +390,7 @@ namespace hex {
                 if (ImGui::ArrowButton("prevPage", ImGuiDir_Left)) {
                     provider->setCurrentPage(provider->getCurrentPage() - 1);
 
-                    EventManager::post<EventRegionSelected>(Region { std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd), 1 });
+                    EventManager::post<EventRegionSelected>(Region { this->getSelection().address, 1 });
                 }
 
                 ImGui::SameLine();
@@ -263,7 +398,7 @@ namespace hex {
                 if (ImGui::ArrowButton("nextPage", ImGuiDir_Right)) {
                     provider->setCurrentPage(provider->getCurrentPage() + 1);
 
-                    EventManager::post<EventRegionSelected>(Region { std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd), 1 });
+                    EventManager::post<EventRegionSelected>(Region { this->getSelection().address, 1 });
                 }
             }
             ImGui::End();
@@ -279,9 +414,34 @@ namespace hex {
     }
 
     static void saveAs() {
-        hex::openFileBrowser("hex.view.hexeditor.save_as"_lang, DialogMode::Save, { }, [](auto path) {
-            auto provider = SharedData::currentProvider;
-            provider->saveAs(path);
+        EventManager::post<RequestOpenWindow>("Save File As");
+    }
+
+    void ViewHexEditor::saveFileAs(const std::string &path) {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr || this->m_saving)
+            return;
+
+        if (this->m_saveThread.joinable())
+            this->m_saveThread.join();
+
+        this->m_saving = true;
+        this->m_cancelSaving = false;
+        this->m_saveProgress = 0;
+
+        View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.saving"_lang); });
+
+        // Edits made while saving must not end up half written, so the patches and overlays are saved as they are right now
+        this->m_saveThread = std::thread([this, provider, path, snapshot = provider->takeSnapshot()] {
+            provider->saveAs(path, snapshot, [this](u64 processed, u64 total) {
+                this->m_saveProgress = total == 0 ? 1.0F : float(processed) / total;
+                return !this->m_cancelSaving;
+            });
+
+            this->m_saving = false;
+
+            // Wake up the main loop so the progress popup gets closed
+            glfwPostEmptyEvent();
         });
     }
 
@@ -306,6 +466,18 @@ namespace hex {
             ImGui::EndPopup();
         }
 
+        if (ImGui::BeginPopupModal("hex.view.hexeditor.saving"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            ImGui::ProgressBar(this->m_saveProgress, ImVec2(300, 0));
+
+            if (ImGui::Button("hex.common.cancel"_lang))
+                this->m_cancelSaving = true;
+
+            if (!this->m_saving)
+                ImGui::CloseCurrentPopup();
+
+            ImGui::EndPopup();
+        }
+
         if (ImGui::BeginPopupModal("hex.view.hexeditor.script.title"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
             ImGui::SetCursorPosX(10);
             ImGui::TextWrapped("hex.view.hexeditor.script.desc"_lang);
@@ -417,6 +589,8 @@ namespace hex {
 
             if (ImGui::MenuItem("hex.view.hexeditor.menu.file.close"_lang, "", false, provider != nullptr && provider->isAvailable())) {
                 EventManager::post<EventFileUnloaded>();
+                this->cancelSearches();
+                this->cancelSaving();
                 delete SharedData::currentProvider;
                 SharedData::currentProvider = nullptr;
             }
@@ -452,6 +626,7 @@ namespace hex {
             if (ImGui::MenuItem("hex.view.hexeditor.menu.file.load_encoding_file"_lang)) {
                 hex::openFileBrowser("hex.view.hexeditor.load_enconding_file"_lang, DialogMode::Open, { }, [this](auto path) {
                     this->m_currEncodingFile = EncodingFile(EncodingFile::Type::Thingy, path);
+                    this->m_memoryEditor.DecodeLookahead = this->m_currEncodingFile.getLongestSequence();
                 });
             }
 
@@ -516,7 +691,7 @@ namespace hex {
 
             if (ImGui::BeginMenu("hex.view.hexeditor.menu.file.export"_lang, provider != nullptr && provider->isWritable())) {
                 if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.ips"_lang)) {
-                    Patches patches = provider->getPatches();
+                    Patches patches = provider->getPatches().toMap();
                     if (!patches.contains(0x00454F45) && patches.contains(0x00454F46)) {
                         u8 value = 0;
                         provider->read(0x00454F45, &value, sizeof(u8));
@@ -529,7 +704,7 @@ namespace hex {
                     });
                 }
                 if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.ips32"_lang)) {
-                    Patches patches = provider->getPatches();
+                    Patches patches = provider->getPatches().toMap();
                     if (!patches.contains(0x00454F45) && patches.contains(0x45454F46)) {
                         u8 value = 0;
                         provider->read(0x45454F45, &value, sizeof(u8));
@@ -573,7 +748,9 @@ namespace hex {
             saveAs();
             return true;
         } else if (ctrl && keys['S']) {
-            save();
+            // Saving in place would change the file that's currently being copied
+            if (!this->m_saving)
+                save();
             return true;
         }
 
@@ -650,9 +827,32 @@ namespace hex {
         return true;
     }
 
+    void ViewHexEditor::cancelSearches() {
+        // Background searches read from the current provider so they need to stop before it gets destroyed
+        for (auto task : { &this->m_stringSearch, &this->m_hexSearch }) {
+            task->cancel();
+            task->clear();
+        }
+
+        this->m_selectFirstSearchResult = false;
+    }
+
+    void ViewHexEditor::cancelSaving() {
+        // The save thread reads from the current provider as well
+        this->m_cancelSaving = true;
+
+        if (this->m_saveThread.joinable())
+            this->m_saveThread.join();
+    }
+
     void ViewHexEditor::openFile(const std::string &path) {
         auto& provider = SharedData::currentProvider;
 
+        if (provider != nullptr)
+            EventManager::post<EventFileUnloaded>();
+
+        this->cancelSearches();
+        this->cancelSaving();
         delete provider;
 
         provider = new prv::FileProvider(path);
@@ -671,6 +871,8 @@ namespace hex {
             return;
         }
 
+        provider->setUndoMemoryLimit(this->m_undoMemoryLimit);
+
         ProjectFile::setFilePath(path);
 
         this->getWindowOpenState() = true;
@@ -695,8 +897,8 @@ namespace hex {
     void ViewHexEditor::copyBytes() const {
         auto provider = SharedData::currentProvider;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t start = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = provider->getCurrentPageOffset() + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
         size_t copySize = (end - start) + 1;
 
@@ -714,8 +916,8 @@ namespace hex {
     void ViewHexEditor::pasteBytes() const {
         auto provider = SharedData::currentProvider;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t start = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = provider->getCurrentPageOffset() + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
         std::string clipboard = ImGui::GetClipboardText();
 
@@ -756,8 +958,8 @@ namespace hex {
     void ViewHexEditor::copyString() const {
         auto provider = SharedData::currentProvider;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t start = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = provider->getCurrentPageOffset() + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
         size_t copySize = (end - start) + 1;
 
@@ -771,8 +973,8 @@ namespace hex {
     void ViewHexEditor::copyLanguageArray(Language language) const {
         auto provider = SharedData::currentProvider;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t start = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = provider->getCurrentPageOffset() + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
         size_t copySize = (end - start) + 1;
 
@@ -873,8 +1075,8 @@ namespace hex {
     void ViewHexEditor::copyHexView() const {
         auto provider = SharedData::currentProvider;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t start = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = provider->getCurrentPageOffset() + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
         size_t copySize = (end - start) + 1;
 
@@ -884,7 +1086,7 @@ namespace hex {
         std::string str = "Hex View  00 01 02 03 04 05 06 07  08 09 0A 0B 0C 0D 0E 0F\n\n";
 
 
-        for (u32 col = start >> 4; col <= (end >> 4); col++) {
+        for (u64 col = start >> 4; col <= (end >> 4); col++) {
             str += hex::format("{0:08X}  ", col << 4);
             for (u64 i = 0 ; i < 16; i++) {
 
@@ -920,8 +1122,8 @@ namespace hex {
     void ViewHexEditor::copyHexViewHTML() const {
         auto provider = SharedData::currentProvider;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t start = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = provider->getCurrentPageOffset() + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
         size_t copySize = (end - start) + 1;
 
@@ -943,7 +1145,7 @@ R"(
 )";
 
 
-        for (u32 col = start >> 4; col <= (end >> 4); col++) {
+        for (u64 col = start >> 4; col <= (end >> 4); col++) {
             str += hex::format("        <span class=\"offsetcolumn\">{0:08X}</span>&nbsp&nbsp<span class=\"hexcolumn\">", col << 4);
             for (u64 i = 0 ; i < 16; i++) {
 
@@ -982,115 +1184,111 @@ R"(
         ImGui::SetClipboardText(str.c_str());
     }
 
-    static std::vector<std::pair<u64, u64>> findString(prv::Provider* &provider, std::string string) {
-        std::vector<std::pair<u64, u64>> results;
-
-        u32 foundCharacters = 0;
-
-        std::vector<u8> buffer(1024, 0x00);
-        size_t dataSize = provider->getSize();
-        for (u64 offset = 0; offset < dataSize; offset += 1024) {
-            size_t usedBufferSize = std::min(u64(buffer.size()), dataSize - offset);
-            provider->readRelative(offset, buffer.data(), usedBufferSize);
-
-            for (u64 i = 0; i < usedBufferSize; i++) {
-                if (buffer[i] == string[foundCharacters])
-                    foundCharacters++;
-                else
-                    foundCharacters = 0;
+    static void findSequence(search::SearchTask &task, std::vector<u8> sequence, std::vector<u8> mask = { }) {
+        auto provider = SharedData::currentProvider;
 
-                if (foundCharacters == string.size()) {
-                    results.emplace_back(offset + i - foundCharacters + 1, offset + i + 1);
-                    foundCharacters = 0;
-                }
-            }
+        if (sequence.empty()) {
+            task.cancel();
+            task.clear();
+            return;
         }
 
-        return results;
+        const size_t size = sequence.size();
+        search::SequenceMatcher matcher(std::move(sequence), std::move(mask));
+
+        task.start(provider, provider->getBaseAddress(), provider->getSize(), [matcher = std::move(matcher)](u64 address, std::span<const u8> data, size_t startLimit, std::vector<Region> &matches) {
+            matcher.find(data, startLimit, [&](size_t offset) {
+                matches.push_back({ address + offset, matcher.getSize() });
+            });
+        }, size);
     }
 
-    static std::vector<std::pair<u64, u64>> findHex(prv::Provider* &provider, std::string string) {
-        std::vector<std::pair<u64, u64>> results;
+    static void findRegex(search::SearchTask &task, search::RegexMatcher matcher) {
+        auto provider = SharedData::currentProvider;
 
-        if ((string.size() % 2) == 1)
-            string = "0" + string;
+        // Matches of the previous chunk may reach into the overlap with the next one. Searching resumes after them so none overlap
+        task.start(provider, provider->getBaseAddress(), provider->getSize(), [matcher = std::move(matcher), resumeAddress = u64(0)](u64 address, std::span<const u8> data, size_t startLimit, std::vector<Region> &matches) mutable {
+            const size_t skip = std::min<u64>(resumeAddress > address ? resumeAddress - address : 0, data.size());
+            if (skip >= startLimit)
+                return;
 
-        std::vector<u8> hex;
-        hex.reserve(string.size() / 2);
+            matcher.find(data.subspan(skip), startLimit - skip, [&](size_t offset, size_t size) {
+                matches.push_back({ address + skip + offset, size });
+                resumeAddress = address + skip + offset + size;
+            });
+        }, search::RegexMatcher::MaxMatchSize);
+    }
 
-        for (u32 i = 0; i < string.size(); i += 2) {
-            char byte[3] = { string[i], string[i + 1], 0 };
-            hex.push_back(strtoul(byte, nullptr, 16));
-        }
+    void ViewHexEditor::findString(search::SearchTask &task, const std::string &string) {
+        this->m_searchInvalid = false;
 
-        u32 foundCharacters = 0;
+        if (string.empty()) {
+            findSequence(task, { });
+        } else if (this->m_searchRegex) {
+            auto matcher = search::RegexMatcher::compile(string, this->m_searchEncoding, this->m_searchIgnoreCase);
+            this->m_searchInvalid = !matcher.has_value();
 
-        std::vector<u8> buffer(1024, 0x00);
-        size_t dataSize = provider->getSize();
-        for (u64 offset = 0; offset < dataSize; offset += 1024) {
-            size_t usedBufferSize = std::min(u64(buffer.size()), dataSize - offset);
-            provider->readRelative(offset, buffer.data(), usedBufferSize);
+            if (matcher.has_value())
+                findRegex(task, std::move(*matcher));
+            else
+                findSequence(task, { });
+        } else {
+            auto pattern = search::encodeText(string, this->m_searchEncoding, this->m_searchIgnoreCase);
+            this->m_searchInvalid = !pattern.has_value();
 
-            for (u64 i = 0; i < usedBufferSize; i++) {
-                if (buffer[i] == hex[foundCharacters])
-                    foundCharacters++;
-                else
-                    foundCharacters = 0;
+            if (!pattern.has_value())
+                pattern = search::BytePattern();
 
-                if (foundCharacters == hex.size()) {
-                    results.emplace_back(offset + i - foundCharacters + 1, offset + i + 1);
-                    foundCharacters = 0;
-                }
-            }
+            findSequence(task, std::move(pattern->bytes), std::move(pattern->mask));
         }
-
-        return results;
     }
 
+    void ViewHexEditor::findHex(search::SearchTask &task, const std::string &string) {
+        auto pattern = search::parseBytePattern(string);
+        this->m_searchInvalid = !pattern.has_value();
 
-    void ViewHexEditor::drawSearchPopup() {
-        static auto InputCallback = [](ImGuiInputTextCallbackData* data) -> int {
-            auto _this = static_cast<ViewHexEditor*>(data->UserData);
-            auto provider = SharedData::currentProvider;
+        if (!pattern.has_value())
+            pattern = search::BytePattern();
 
-            *_this->m_lastSearchBuffer = _this->m_searchFunction(provider, data->Buf);
-            _this->m_lastSearchIndex = 0;
+        findSequence(task, std::move(pattern->bytes), std::move(pattern->mask));
+    }
 
-            if (!_this->m_lastSearchBuffer->empty())
-                _this->m_memoryEditor.GotoAddrAndSelect((*_this->m_lastSearchBuffer)[0].first, (*_this->m_lastSearchBuffer)[0].second);
 
-            return 0;
+    void ViewHexEditor::drawSearchPopup() {
+        static auto Find = [this](const char *buffer) {
+            (this->*this->m_searchFunction)(*this->m_currSearch, buffer);
+            this->m_selectFirstSearchResult = true;
         };
 
-        static auto Find = [this](char *buffer) {
-            auto provider = SharedData::currentProvider;
+        static auto InputCallback = [](ImGuiInputTextCallbackData* data) -> int {
+            // Hex patterns may contain '?' wildcards and spaces between bytes
+            if (data->EventFlag == ImGuiInputTextFlags_CallbackCharFilter)
+                return !(data->EventChar < 0x80 && (std::isxdigit(data->EventChar) || data->EventChar == '?' || data->EventChar == ' '));
 
-            *this->m_lastSearchBuffer = this->m_searchFunction(provider, buffer);
-            this->m_lastSearchIndex = 0;
+            // Searching happens in the background, so it's restarted on every edit without blocking the UI
+            Find(data->Buf);
 
-            if (!this->m_lastSearchBuffer->empty())
-                this->m_memoryEditor.GotoAddrAndSelect((*this->m_lastSearchBuffer)[0].first, (*this->m_lastSearchBuffer)[0].second);
+            return 0;
         };
 
+        // Next and previous are relative to the cursor so they keep working after moving around in the file
         static auto FindNext = [this]() {
-            if (!this->m_lastSearchBuffer->empty()) {
-                ++this->m_lastSearchIndex %= this->m_lastSearchBuffer->size();
-                this->m_memoryEditor.GotoAddrAndSelect((*this->m_lastSearchBuffer)[this->m_lastSearchIndex].first,
-                                                          (*this->m_lastSearchBuffer)[this->m_lastSearchIndex].second);
+            auto count = this->m_currSearch->getResultCount();
+            if (count > 0) {
+                auto selection = this->getSelection();
+                auto index = selection.address == u64(-1) ? 0 : this->m_currSearch->findResult(selection.address + 1);
+
+                selectSearchResult(*this->m_currSearch->getResult(index < count ? index : 0));
             }
         };
 
         static auto FindPrevious = [this]() {
-            if (!this->m_lastSearchBuffer->empty()) {
-                this->m_lastSearchIndex--;
+            auto count = this->m_currSearch->getResultCount();
+            if (count > 0) {
+                auto selection = this->getSelection();
+                auto index = selection.address == u64(-1) ? 0 : this->m_currSearch->findResult(selection.address);
 
-                if (this->m_lastSearchIndex < 0)
-                    this->m_lastSearchIndex = this->m_lastSearchBuffer->size() - 1;
-
-                this->m_lastSearchIndex %= this->m_lastSearchBuffer->size();
-
-                this->m_memoryEditor.GotoAddrAndSelect((*this->m_lastSearchBuffer)[this->m_lastSearchIndex].first,
-                                                          (*this->m_lastSearchBuffer)[this->m_lastSearchIndex].second);
+                selectSearchResult(*this->m_currSearch->getResult(index > 0 ? index - 1 : count - 1));
             }
         };
 
@@ -1099,31 +1297,44 @@ R"(
             if (ImGui::BeginTabBar("searchTabs")) {
                 std::vector<char> *currBuffer = nullptr;
                 if (ImGui::BeginTabItem("hex.view.hexeditor.search.string"_lang)) {
-                    this->m_searchFunction = findString;
-                    this->m_lastSearchBuffer = &this->m_lastStringSearch;
+                    this->m_searchFunction = &ViewHexEditor::findString;
+                    this->m_currSearch = &this->m_stringSearch;
                     currBuffer = &this->m_searchStringBuffer;
 
-                    ImGui::InputText("##nolabel", currBuffer->data(), currBuffer->size(), ImGuiInputTextFlags_CallbackCompletion,
+                    ImGui::InputText("##nolabel", currBuffer->data(), currBuffer->size(), ImGuiInputTextFlags_CallbackEdit,
                                      InputCallback, this);
+
+                    constexpr static std::array EncodingNames = { "UTF-8", "UTF-16LE", "UTF-16BE" };
+
+                    bool optionsChanged = false;
+                    optionsChanged |= ImGui::Combo("hex.view.hexeditor.search.encoding"_lang, reinterpret_cast<int*>(&this->m_searchEncoding), EncodingNames.data(), EncodingNames.size());
+                    optionsChanged |= ImGui::Checkbox("hex.view.hexeditor.search.ignore_case"_lang, &this->m_searchIgnoreCase);
+                    ImGui::SameLine();
+                    optionsChanged |= ImGui::Checkbox("hex.view.hexeditor.search.regex"_lang, &this->m_searchRegex);
+
+                    if (optionsChanged)
+                        Find(currBuffer->data());
                     ImGui::EndTabItem();
                 }
 
                 if (ImGui::BeginTabItem("hex.view.hexeditor.search.hex"_lang)) {
-                    this->m_searchFunction = findHex;
-                    this->m_lastSearchBuffer = &this->m_lastHexSearch;
+                    this->m_searchFunction = &ViewHexEditor::findHex;
+                    this->m_currSearch = &this->m_hexSearch;
                     currBuffer = &this->m_searchHexBuffer;
 
                     ImGui::InputText("##nolabel", currBuffer->data(), currBuffer->size(),
-                                     ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CallbackCompletion,
+                                     ImGuiInputTextFlags_CallbackCharFilter | ImGuiInputTextFlags_CallbackEdit,
                                      InputCallback, this);
                     ImGui::EndTabItem();
                 }
 
                 if (currBuffer != nullptr) {
+                    auto resultCount = this->m_currSearch->getResultCount();
+
                     if (ImGui::Button("hex.view.hexeditor.search.find"_lang))
                         Find(currBuffer->data());
 
-                    if (!this->m_lastSearchBuffer->empty()) {
+                    if (resultCount > 0) {
                         if ((ImGui::Button("hex.view.hexeditor.search.find_next"_lang)))
                             FindNext();
 
@@ -1132,6 +1343,49 @@ R"(
                         if ((ImGui::Button("hex.view.hexeditor.search.find_prev"_lang)))
                             FindPrevious();
                     }
+
+                    if (this->m_currSearch->isRunning())
+                        ImGui::ProgressBar(this->m_currSearch->getProgress(), ImVec2(0, 0), hex::format("hex.view.hexeditor.search.results"_lang, resultCount).c_str());
+                    else if (this->m_searchInvalid)
+                        ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", static_cast<const char*>("hex.view.hexeditor.search.invalid"_lang));
+                    else
+                        ImGui::TextUnformatted(hex::format("hex.view.hexeditor.search.results"_lang, resultCount).c_str());
+
+                    if (this->m_currSearch->hasHitResultLimit())
+                        ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", hex::format("hex.view.hexeditor.search.result_limit"_lang, search::SearchTask::MaxResults).c_str());
+
+                    // Only the visible rows are ever decoded from the compressed result list
+                    if (resultCount > 0 && ImGui::BeginTable("##results", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, 200 * SharedData::globalScale))) {
+                        ImGui::TableSetupScrollFreeze(0, 1);
+                        ImGui::TableSetupColumn("hex.common.address"_lang);
+                        ImGui::TableSetupColumn("hex.common.size"_lang);
+                        ImGui::TableHeadersRow();
+
+                        ImGuiListClipper clipper;
+                        clipper.Begin(resultCount);
+
+                        while (clipper.Step()) {
+                            for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                                auto result = this->m_currSearch->getResult(i);
+                                if (!result.has_value())
+                                    break;
+
+                                ImGui::TableNextRow();
+                                ImGui::TableNextColumn();
+
+                                ImGui::PushID(i);
+                                if (ImGui::Selectable(hex::format("0x{:08X}", result->address).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                                    selectSearchResult(*result);
+                                ImGui::PopID();
+
+                                ImGui::TableNextColumn();
+                                ImGui::TextUnformatted(hex::format("0x{:X}", result->size).c_str());
+                            }
+                        }
+                        clipper.End();
+
+                        ImGui::EndTable();
+                    }
                 }
 
                 ImGui::EndTabBar();
@@ -1174,7 +1428,7 @@ R"(
                 if (ImGui::BeginTabItem("hex.view.hexeditor.goto.offset.current"_lang)) {
                     ImGui::InputScalar("dec", ImGuiDataType_S64, &this->m_gotoAddress, nullptr, nullptr, "%lld", ImGuiInputTextFlags_CharsDecimal);
 
-                    s64 currSelectionOffset = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+                    s64 currSelectionOffset = provider->getCurrentPageOffset() + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
                     if (currSelectionOffset + this->m_gotoAddress < 0)
                         this->m_gotoAddress = -currSelectionOffset;
@@ -1197,7 +1451,6 @@ R"(
                 }
 
                 if (ImGui::Button("hex.view.hexeditor.menu.file.goto"_lang)) {
-                    provider->setCurrentPage(std::floor(double(newOffset - baseAddress) / prv::Provider::PageSize));
                     EventManager::post<RequestSelectionChange>(Region { newOffset, 1 });
                 }
 
@@ -1261,12 +1514,9 @@ R"(
         ImGui::Separator();
 
         if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.bookmark"_lang, nullptr, false, this->m_memoryEditor.DataPreviewAddr != -1 && this->m_memoryEditor.DataPreviewAddrEnd != -1)) {
-            auto base = SharedData::currentProvider->getBaseAddress();
-
-            size_t start = base + std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-            size_t end = base + std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+            auto selection = this->getSelection();
 
-            ImHexApi::Bookmarks::add(start, end - start + 1, { }, { });
+            ImHexApi::Bookmarks::add(selection.address, selection.size, { }, { });
         }
 
         auto provider = SharedData::currentProvider;
@@ -24,15 +24,11 @@ namespace hex {
 
     ViewInformation::ViewInformation() : View("hex.view.information.name") {
         EventManager::subscribe<EventDataChanged>(this, [this]() {
-            this->m_dataValid = false;
-            this->m_highestBlockEntropy = 0;
-            this->m_blockEntropy.clear();
-            this->m_averageEntropy = 0;
-            this->m_blockSize = 0;
-            this->m_valueCounts.fill(0x00);
-            this->m_mimeType = "";
-            this->m_fileDescription = "";
-            this->m_analyzedRegion = { 0, 0 };
+            this->clearAnalysis();
+        });
+
+        EventManager::subscribe<EventFileUnloaded>(this, [this]() {
+            this->clearAnalysis();
         });
 
         EventManager::subscribe<EventRegionSelected>(this, [this](Region region) {
@@ -43,69 +39,71 @@ namespace hex {
 
     ViewInformation::~ViewInformation() {
         EventManager::unsubscribe<EventDataChanged>(this);
+        EventManager::unsubscribe<EventFileUnloaded>(this);
         EventManager::unsubscribe<EventRegionSelected>(this);
-    }
-
-    static float calculateEntropy(std::array<ImU64, 256> &valueCounts, size_t numBytes) {
-        float entropy = 0;
-
-        if (numBytes == 0)
-            return 0.0F;
 
-        std::array<float, 256> floatValueCounts{ 0 };
-        std::copy(valueCounts.begin(), valueCounts.end(), floatValueCounts.begin());
-
-        for (u16 i = 0; i < 256; i++) {
-            floatValueCounts[i] /= float(numBytes);
-
-            if (floatValueCounts[i] > 0)
-                entropy -= (floatValueCounts[i] * std::log2(floatValueCounts[i]));
-        }
+        this->clearAnalysis();
+    }
 
-        return entropy / 8;
+    void ViewInformation::clearAnalysis() {
+        this->m_analyzer.cancel();
+        if (this->m_magicThread.joinable())
+            this->m_magicThread.join();
+        this->m_analyzing = false;
+
+        this->m_dataValid = false;
+        this->m_highestBlockEntropy = 0;
+        this->m_blockEntropy.clear();
+        this->m_averageEntropy = 0;
+        this->m_blockSize = 0;
+        this->m_valueCounts.fill(0x00);
+        this->m_mimeType = "";
+        this->m_fileDescription = "";
+        this->m_analyzedRegion = { 0, 0 };
     }
 
     void ViewInformation::analyze() {
+        auto provider = SharedData::currentProvider;
+
         this->m_analyzing = true;
+        this->m_analyzedRegion = { provider->getBaseAddress(), provider->getBaseAddress() + provider->getSize() };
+        this->m_blockSize = std::max<u32>(std::ceil(provider->getSize() / 2048.0F), 256);
 
-        std::thread([this]{
-            auto provider = SharedData::currentProvider;
+        this->m_analyzer.start(provider, provider->getBaseAddress(), provider->getSize(), this->m_blockSize);
 
-            this->m_analyzedRegion = { provider->getBaseAddress(), provider->getBaseAddress() + provider->getSize() };
+        this->m_magicDone = false;
+        this->m_magicThread = std::thread([this, provider] {
+            this->m_pendingFileDescription = magic::getDescription(provider);
+            this->m_pendingMimeType = magic::getMIMEType(provider);
+            this->m_magicDone = true;
+        });
+    }
 
-            {
-                this->m_blockSize = std::max<u32>(std::ceil(provider->getSize() / 2048.0F), 256);
-                std::vector<u8> buffer(this->m_blockSize, 0x00);
-                std::memset(this->m_valueCounts.data(), 0x00, this->m_valueCounts.size() * sizeof(u32));
-                this->m_blockEntropy.clear();
-                this->m_valueCounts.fill(0);
+    void ViewInformation::finishAnalysis() {
+        if (!this->m_analyzing || this->m_analyzer.isRunning() || !this->m_magicDone)
+            return;
 
-                for (u64 i = 0; i < provider->getSize(); i += this->m_blockSize) {
-                    std::array<ImU64, 256> blockValueCounts = { 0 };
-                    provider->readRelative(i, buffer.data(), std::min(u64(this->m_blockSize), provider->getSize() - i));
+        this->m_magicThread.join();
+        this->m_analyzing = false;
 
-                    for (size_t j = 0; j < this->m_blockSize; j++) {
-                        blockValueCounts[buffer[j]]++;
-                        this->m_valueCounts[buffer[j]]++;
-                    }
-                    this->m_blockEntropy.push_back(calculateEntropy(blockValueCounts, this->m_blockSize));
-                }
+        auto result = this->m_analyzer.takeResult();
+        if (!result.has_value())
+            return;
 
-                this->m_averageEntropy = calculateEntropy(this->m_valueCounts, provider->getSize());
-                this->m_highestBlockEntropy = *std::max_element(this->m_blockEntropy.begin(), this->m_blockEntropy.end());
-            }
+        std::copy(result->valueCounts.begin(), result->valueCounts.end(), this->m_valueCounts.begin());
+        this->m_blockEntropy = std::move(result->blockEntropy);
 
-            {
-                this->m_fileDescription = magic::getDescription(provider);
-                this->m_mimeType = magic::getMIMEType(provider);
-                this->m_dataValid = true;
-            }
+        this->m_averageEntropy = ByteAnalyzer::calculateEntropy(result->valueCounts, this->m_analyzedRegion.second - this->m_analyzedRegion.first);
+        this->m_highestBlockEntropy = this->m_blockEntropy.empty() ? 0 : *std::max_element(this->m_blockEntropy.begin(), this->m_blockEntropy.end());
 
-            this->m_analyzing = false;
-        }).detach();
+        this->m_fileDescription = std::move(this->m_pendingFileDescription);
+        this->m_mimeType = std::move(this->m_pendingMimeType);
+        this->m_dataValid = true;
     }
 
     void ViewInformation::drawContent() {
+        this->finishAnalysis();
+
         if (ImGui::Begin(View::toWindowName("hex.view.information.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             if (ImGui::BeginChild("##scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav)) {
 
@@ -122,7 +120,7 @@ namespace hex {
 
                     if (this->m_analyzing) {
                         ImGui::SameLine();
-                        ImGui::TextSpinner("hex.view.information.analyzing"_lang);
+                        ImGui::ProgressBar(this->m_analyzer.getProgress(), ImVec2(200, 0), "hex.view.information.analyzing"_lang);
                     }
 
                     if (this->m_dataValid) {
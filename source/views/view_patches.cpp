@@ -14,13 +14,13 @@ namespace hex {
         EventManager::subscribe<EventProjectFileStore>(this, []{
             auto provider = SharedData::currentProvider;
             if (provider != nullptr)
-                ProjectFile::setPatches(provider->getPatches());
+                ProjectFile::setPatches(provider->getPatches().toMap());
         });
 
         EventManager::subscribe<EventProjectFileLoad>(this, []{
             auto provider = SharedData::currentProvider;
             if (provider != nullptr)
-                provider->getPatches() = ProjectFile::getPatches();
+                provider->getPatches() = prv::PatchTree(ProjectFile::getPatches());
         });
     }
 
@@ -46,29 +46,32 @@ namespace hex {
 
                     auto& patches = provider->getPatches();
                     u32 index = 0;
-                    for (const auto &[address, patch] : patches) {
-
-                        ImGui::TableNextRow();
-                        ImGui::TableNextColumn();
-                        if (ImGui::Selectable(("##patchLine" + std::to_string(index)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                            EventManager::post<RequestSelectionChange>(Region { address, 1 });
-                        }
-                        if (ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
-                            ImGui::OpenPopup("PatchContextMenu");
-                            this->m_selectedPatch = address;
+                    patches.forEach([&, this](u64 extentAddress, std::span<const u8> extent) {
+                        for (u64 i = 0; i < extent.size(); i++) {
+                            u64 address = extentAddress + i;
+
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            if (ImGui::Selectable(("##patchLine" + std::to_string(index)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
+                                EventManager::post<RequestSelectionChange>(Region { address, 1 });
+                            }
+                            if (ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
+                                ImGui::OpenPopup("PatchContextMenu");
+                                this->m_selectedPatch = address;
+                            }
+                            ImGui::SameLine();
+                            ImGui::Text("0x%08lX", address);
+
+                            ImGui::TableNextColumn();
+                            u8 previousValue = 0x00;
+                            provider->readRaw(address, &previousValue, sizeof(u8));
+                            ImGui::Text("0x%02X", previousValue);
+
+                            ImGui::TableNextColumn();
+                            ImGui::Text("0x%02X", extent[i]);
+                            index += 1;
                         }
-                        ImGui::SameLine();
-                        ImGui::Text("0x%08lX", address);
-
-                        ImGui::TableNextColumn();
-                        u8 previousValue = 0x00;
-                        provider->readRaw(address, &previousValue, sizeof(u8));
-                        ImGui::Text("0x%02X", previousValue);
-
-                        ImGui::TableNextColumn();
-                        ImGui::Text("0x%02X", patch);
-                        index += 1;
-                    }
+                    });
 
                     if (ImGui::BeginPopup("PatchContextMenu")) {
                         if (ImGui::MenuItem("hex.view.patches.remove"_lang)) {
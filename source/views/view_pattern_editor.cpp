@@ -14,6 +14,8 @@
 
 #include <nlohmann/json.hpp>
 
+#include <GLFW/glfw3.h>
+
 namespace hex {
 
     using namespace hex::literals;
@@ -361,6 +363,9 @@ namespace hex {
             }
 
             this->m_evaluatorRunning = false;
+
+            // Wake up the main loop so the new patterns get drawn
+            glfwPostEmptyEvent();
         }).detach();
 
     }
@@ -1,10 +1,16 @@
 #include "views/view_strings.hpp"
 
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/helpers/fmt.hpp>
+
+#include "helpers/project_file_handler.hpp"
 
 #include <cstring>
 #include <thread>
 
+#include <nlohmann/json.hpp>
+
 #include <llvm/Demangle/Demangle.h>
 #include <imgui_imhex_extensions.h>
 
@@ -14,7 +20,19 @@ namespace hex {
 
     ViewStrings::ViewStrings() : View("hex.view.strings.name") {
         EventManager::subscribe<EventDataChanged>(this, [this]() {
-            this->m_foundStrings.clear();
+            this->clearStrings();
+        });
+
+        EventManager::subscribe<EventFileUnloaded>(this, [this]() {
+            this->clearStrings();
+        });
+
+        EventManager::subscribe<EventProjectFileLoad>(this, [this]() {
+            this->loadCache();
+        });
+
+        EventManager::subscribe<EventProjectFileStore>(this, [this]() {
+            this->storeCache();
         });
 
         this->m_filter.reserve(0xFFFF);
@@ -23,19 +41,17 @@ namespace hex {
 
     ViewStrings::~ViewStrings() {
         EventManager::unsubscribe<EventDataChanged>(this);
-    }
-
-    std::string readString(const FoundString &foundString) {
-        std::string string(foundString.size + 1, '\0');
-        SharedData::currentProvider->read(foundString.offset, string.data(), foundString.size);
+        EventManager::unsubscribe<EventFileUnloaded>(this);
+        EventManager::unsubscribe<EventProjectFileLoad>(this);
+        EventManager::unsubscribe<EventProjectFileStore>(this);
 
-        return string;
+        this->clearStrings();
     }
 
-    void ViewStrings::createStringContextMenu(const FoundString &foundString) {
-        if (ImGui::TableGetColumnFlags(2) == ImGuiTableColumnFlags_IsHovered && ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
+    void ViewStrings::createStringContextMenu(std::string_view string) {
+        if (ImGui::TableGetColumnFlags(3) == ImGuiTableColumnFlags_IsHovered && ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
             ImGui::OpenPopup("StringContextMenu");
-            this->m_selectedString = readString(foundString);
+            this->m_selectedString = string;
         }
         if (ImGui::BeginPopup("StringContextMenu")) {
             if (ImGui::MenuItem("hex.view.strings.copy"_lang)) {
@@ -52,115 +68,367 @@ namespace hex {
     }
 
     void ViewStrings::searchStrings() {
+        this->clearStrings();
+
+        this->m_cachedStrings.reset();
+
+        StringExtractor::Settings settings;
+        settings.minimumLength = std::max(this->m_minimumLength, 1);
+        settings.encodings.clear();
+        for (u32 i = 0; i < this->m_encodings.size(); i++) {
+            if (this->m_encodings[i])
+                settings.encodings.push_back(StringEncoding(i));
+        }
+
+        this->m_extractor.start(SharedData::currentProvider, settings);
+    }
+
+    void ViewStrings::clearStrings() {
+        this->m_extractor.cancel();
+
+        if (this->m_sortThread.joinable())
+            this->m_sortThread.join();
+        this->m_sortedIndices.clear();
+        this->m_filterGeneration++;
+
+        // Strings loaded from a project are checked again once the data stops changing
+        this->m_verifyingCache = false;
+        this->m_exportFile.reset();
+
         this->m_foundStrings.clear();
+        this->m_strings.clear();
         this->m_filterIndices.clear();
-        this->m_searching = true;
-
-        std::thread([this] {
-            auto provider = SharedData::currentProvider;
-
-            std::vector<u8> buffer(1024, 0x00);
-            u32 foundCharacters = 0;
-
-            for (u64 offset = 0; offset < provider->getSize(); offset += buffer.size()) {
-                size_t readSize = std::min(u64(buffer.size()), provider->getSize() - offset);
-                provider->readRelative(offset,  buffer.data(), readSize);
-
-                for (u32 i = 0; i < readSize; i++) {
-                    if (buffer[i] >= ' ' && buffer[i] <= '~' && offset < provider->getSize() - 1)
-                        foundCharacters++;
-                    else {
-                        if (foundCharacters >= this->m_minimumLength) {
-                            FoundString foundString = {
-                                offset + i - foundCharacters + provider->getBaseAddress(),
-                                foundCharacters
-                            };
-
-                            this->m_foundStrings.push_back(foundString);
-                            this->m_filterIndices.push_back(this->m_foundStrings.size() - 1);
-                        }
+    }
+
+    bool ViewStrings::needsRedraw() {
+        // Results published by the last workers still need to be collected, exported and checked against the cache after they stopped
+        return this->m_extractor.isRunning() || this->m_extractor.hasPendingResults() || this->m_sortThread.joinable() || this->m_verifyingCache || this->m_exportFile.has_value();
+    }
+
+    void ViewStrings::collectResults() {
+        // The sort reads the strings so new ones are only taken once it's done
+        if (this->m_sortThread.joinable())
+            return;
+
+        const bool finished = !this->m_extractor.isRunning();
+
+        // Strings are found on worker threads and only handed over to the UI thread here, so nothing else ever modifies m_foundStrings
+        auto prevCount = this->m_foundStrings.size();
+        this->m_extractor.takeResults(this->m_foundStrings, this->m_strings);
+        this->filterStrings(prevCount);
 
-                        foundCharacters = 0;
+        if (this->m_exportFile.has_value()) {
+            this->exportStrings();
+
+            if (finished)
+                this->m_exportFile.reset();
+        }
+    }
+
+    void ViewStrings::filterStrings(size_t from) {
+        this->m_strings.find(this->m_appliedFilter, from, this->m_filterIndices);
+    }
+
+    void ViewStrings::updateFilter() {
+        std::string filter = this->m_filter.c_str();
+
+        // Strings that don't contain the previous filter can't contain one that includes it either
+        if (!this->m_appliedFilter.empty() && filter.find(this->m_appliedFilter) != std::string::npos) {
+            this->m_strings.narrow(filter, this->m_filterIndices);
+        } else {
+            this->m_filterIndices.clear();
+            this->m_strings.find(filter, 0, this->m_filterIndices);
+            this->m_sortNeeded = true;
+        }
+
+        this->m_appliedFilter = std::move(filter);
+        this->m_filterGeneration++;
+    }
+
+    void ViewStrings::sortStrings(SortColumn column, bool descending) {
+        this->m_sortGeneration = this->m_filterGeneration;
+        this->m_sorting = true;
+
+        // The strings aren't modified while the sort is running as new results are only taken once it's done
+        this->m_sortThread = std::thread([this, column, descending, indices = this->m_filterIndices] {
+            struct SortKey {
+                u64 key;
+                size_t index;
+            };
+
+            // Strings are ordered by their first 8 bytes first and only compared in full if those are equal
+            std::vector<SortKey> keys;
+            keys.reserve(indices.size());
+            for (size_t index : indices) {
+                const auto &foundString = this->m_foundStrings[index];
+
+                u64 key = 0;
+                switch (column) {
+                    case SortColumn::Offset:   key = foundString.offset; break;
+                    case SortColumn::Size:     key = foundString.size; break;
+                    case SortColumn::Encoding: key = u64(foundString.encoding); break;
+                    case SortColumn::String: {
+                        auto string = this->m_strings.get(index);
+                        for (size_t i = 0; i < sizeof(key); i++)
+                            key = (key << 8) | (i < string.size() ? u8(string[i]) : 0x00);
+                        break;
                     }
                 }
+
+                keys.push_back({ key, index });
+            }
+
+            auto less = [&](const SortKey &left, const SortKey &right) {
+                if (left.key != right.key)
+                    return left.key < right.key;
+                if (column == SortColumn::String) {
+                    if (auto order = this->m_strings.get(left.index).compare(this->m_strings.get(right.index)); order != 0)
+                        return order < 0;
+                }
+
+                return left.index < right.index;
+            };
+
+            parallelSort(keys.begin(), keys.end(), [&](const SortKey &left, const SortKey &right) {
+                return descending ? less(right, left) : less(left, right);
+            });
+
+            this->m_sortedIndices.clear();
+            for (const auto &key : keys)
+                this->m_sortedIndices.push_back(key.index);
+
+            this->m_sorting = false;
+        });
+    }
+
+    void ViewStrings::finishSorting() {
+        if (!this->m_sortThread.joinable() || this->m_sorting)
+            return;
+
+        this->m_sortThread.join();
+
+        // The filter changed while sorting, so the sorted list is outdated already
+        if (this->m_sortGeneration == this->m_filterGeneration)
+            this->m_filterIndices = std::move(this->m_sortedIndices);
+        else
+            this->m_sortNeeded = true;
+
+        this->m_sortedIndices.clear();
+    }
+
+    void ViewStrings::loadCache() {
+        this->clearStrings();
+        this->m_cachedStrings.reset();
+
+        if (ProjectFile::getStrings().empty())
+            return;
+
+        try {
+            auto cache = nlohmann::json::parse(ProjectFile::getStrings());
+
+            CachedStrings cachedStrings;
+            cachedStrings.hash = cache["hash"].get<u64>();
+
+            for (const auto &string : cache["strings"]) {
+                cachedStrings.strings.push_back({ string[0].get<u64>(), string[1].get<size_t>(), StringEncoding(string[2].get<u8>()) });
+                cachedStrings.texts.add(string[3].get<std::string>());
             }
 
-            this->m_searching = false;
-        }).detach();
+            this->m_minimumLength = cache["minimumLength"].get<int>();
+            this->m_encodings = cache["encodings"].get<std::array<bool, 6>>();
+            this->m_cachedStrings = std::move(cachedStrings);
+        } catch (nlohmann::json::exception &e) {
+            return;
+        }
+    }
+
+    void ViewStrings::storeCache() {
+        // Strings loaded from the project that haven't been checked against the data yet stay in it unchanged
+        if (this->m_cachedStrings.has_value())
+            return;
+
+        this->collectResults();
+
+        auto hash = this->m_extractor.getContentHash();
+        if (!hash.has_value() || this->m_foundStrings.empty()) {
+            ProjectFile::setStrings("");
+            return;
+        }
+
+        auto strings = nlohmann::json::array();
+        for (u64 i = 0; i < this->m_foundStrings.size(); i++) {
+            const auto &foundString = this->m_foundStrings[i];
+            strings.push_back({ foundString.offset, foundString.size, u8(foundString.encoding), std::string(this->m_strings.get(i)) });
+        }
+
+        nlohmann::json cache = {
+            { "hash", *hash },
+            { "minimumLength", this->m_minimumLength },
+            { "encodings", this->m_encodings },
+            { "strings", std::move(strings) }
+        };
+
+        ProjectFile::setStrings(cache.dump());
+    }
+
+    void ViewStrings::checkCache() {
+        auto provider = SharedData::currentProvider;
+
+        if (!this->m_cachedStrings.has_value() || provider == nullptr || !provider->isReadable())
+            return;
+        if (this->m_extractor.isRunning() || this->m_sortThread.joinable())
+            return;
+
+        // Extracting with no encodings selected only hashes the data
+        if (!this->m_verifyingCache) {
+            StringExtractor::Settings settings;
+            settings.encodings.clear();
+
+            this->m_extractor.start(provider, settings);
+            this->m_verifyingCache = true;
+            return;
+        }
+
+        if (this->m_extractor.getContentHash() == this->m_cachedStrings->hash) {
+            this->m_foundStrings = std::move(this->m_cachedStrings->strings);
+            this->m_strings = std::move(this->m_cachedStrings->texts);
+
+            this->m_filterIndices.clear();
+            this->filterStrings(0);
+            this->m_sortNeeded = true;
+        }
 
+        this->m_cachedStrings.reset();
+        this->m_verifyingCache = false;
+    }
+
+    void ViewStrings::startExport(const std::string &path) {
+        this->m_exportFile.emplace(path, File::Mode::Create);
+        if (!this->m_exportFile->isValid()) {
+            this->m_exportFile.reset();
+            View::showErrorPopup("hex.view.strings.export.error"_lang);
+            return;
+        }
+
+        this->m_exportJson = path.ends_with(".jsonl");
+        this->m_exportedCount = 0;
+
+        if (!this->m_exportJson)
+            this->m_exportFile->write("offset,size,encoding,string\n"s);
+    }
+
+    void ViewStrings::exportStrings() {
+        std::string lines;
+
+        // Strings are written out as they're found, the file is closed once the extraction is done
+        for (; this->m_exportedCount < this->m_foundStrings.size(); this->m_exportedCount++) {
+            const auto &foundString = this->m_foundStrings[this->m_exportedCount];
+            const std::string text(this->m_strings.get(this->m_exportedCount));
+            const auto encoding = StringExtractor::getEncodingName(foundString.encoding);
+
+            if (this->m_exportJson) {
+                lines += nlohmann::json({ { "offset", foundString.offset }, { "size", foundString.size }, { "encoding", encoding }, { "string", text } }).dump();
+                lines += '\n';
+            } else {
+                std::string escaped;
+                for (char c : text) {
+                    if (c == '"')
+                        escaped += '"';
+                    escaped += c;
+                }
+
+                lines += hex::format("0x{:08X},0x{:X},{},\"{}\"\n", foundString.offset, foundString.size, encoding, escaped);
+            }
+        }
+
+        this->m_exportFile->write(lines);
     }
 
     void ViewStrings::drawContent() {
         auto provider = SharedData::currentProvider;
 
+        this->finishSorting();
+        this->checkCache();
+        this->collectResults();
+
         if (ImGui::Begin(View::toWindowName("hex.view.strings.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             if (provider != nullptr && provider->isReadable()) {
                 ImGui::Disabled([this]{
                     if (ImGui::InputInt("hex.view.strings.min_length"_lang, &this->m_minimumLength, 1, 0))
-                        this->m_foundStrings.clear();
+                        this->clearStrings();
+
+                    for (u32 i = 0; i < this->m_encodings.size(); i++) {
+                        if (i != 0)
+                            ImGui::SameLine();
+
+                        if (ImGui::Checkbox(StringExtractor::getEncodingName(StringEncoding(i)), &this->m_encodings[i]))
+                            this->clearStrings();
+                    }
 
                     ImGui::InputText("hex.view.strings.filter"_lang, this->m_filter.data(), this->m_filter.capacity(), ImGuiInputTextFlags_CallbackEdit, [](ImGuiInputTextCallbackData *data) {
                         auto &view = *static_cast<ViewStrings*>(data->UserData);
                         view.m_filter.resize(data->BufTextLen);
 
-                        view.m_filterIndices.clear();
-                        for (u64 i = 0; i < view.m_foundStrings.size(); i++) {
-                            if (readString(view.m_foundStrings[i]).find(data->Buf) != std::string::npos)
-                                view.m_filterIndices.push_back(i);
-                        }
+                        view.updateFilter();
 
                         return 0;
                     }, this);
 
                     if (ImGui::Button("hex.view.strings.extract"_lang))
                         this->searchStrings();
-                }, this->m_searching);
+                }, this->m_extractor.isRunning());
+
+                ImGui::SameLine();
+                ImGui::Disabled([this] {
+                    if (ImGui::Button("hex.view.strings.export"_lang)) {
+                        hex::openFileBrowser("hex.view.strings.export"_lang, DialogMode::Save, { { "CSV", "csv" }, { "JSON Lines", "jsonl" } }, [this](auto path) {
+                            this->startExport(path);
+                        });
+                    }
+                }, this->m_exportFile.has_value() || this->m_verifyingCache || (this->m_foundStrings.empty() && !this->m_extractor.isRunning()));
 
-                if (this->m_searching) {
+                if (this->m_extractor.isRunning()) {
                     ImGui::SameLine();
-                    ImGui::TextSpinner("hex.view.strings.searching"_lang);
+                    ImGui::ProgressBar(this->m_extractor.getProgress(), ImVec2(200, 0), this->m_verifyingCache ? "hex.view.strings.verifying"_lang : "hex.view.strings.searching"_lang);
+                } else if (this->m_sortThread.joinable()) {
+                    ImGui::SameLine();
+                    ImGui::TextSpinner("hex.view.strings.sorting"_lang);
                 }
 
-
                 ImGui::Separator();
                 ImGui::NewLine();
 
-                if (ImGui::BeginTable("##strings", 3,
+                if (ImGui::BeginTable("##strings", 4,
                                       ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable |
                                       ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                     ImGui::TableSetupScrollFreeze(0, 1);
                     ImGui::TableSetupColumn("hex.view.strings.offset"_lang, 0, -1, ImGui::GetID("offset"));
                     ImGui::TableSetupColumn("hex.view.strings.size"_lang, 0, -1, ImGui::GetID("size"));
+                    ImGui::TableSetupColumn("hex.view.strings.encoding"_lang, 0, -1, ImGui::GetID("encoding"));
                     ImGui::TableSetupColumn("hex.view.strings.string"_lang, 0, -1, ImGui::GetID("string"));
 
                     auto sortSpecs = ImGui::TableGetSortSpecs();
 
                     if (sortSpecs->SpecsDirty) {
-                        std::sort(this->m_foundStrings.begin(), this->m_foundStrings.end(),
-                                  [&sortSpecs](FoundString &left, FoundString &right) -> bool {
-                                      if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.offset > right.offset;
-                                          else
-                                              return left.offset < right.offset;
-                                      } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.size > right.size;
-                                          else
-                                              return left.size < right.size;
-                                      } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("string")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return readString(left) > readString(right);
-                                          else
-                                              return readString(left) < readString(right);
-                                      }
-
-                                      return false;
-                                  });
-
+                        this->m_sortNeeded = true;
                         sortSpecs->SpecsDirty = false;
                     }
 
+                    if (this->m_sortNeeded && !this->m_sortThread.joinable() && sortSpecs->SpecsCount > 0) {
+                        SortColumn column;
+                        if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset"))
+                            column = SortColumn::Offset;
+                        else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size"))
+                            column = SortColumn::Size;
+                        else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("encoding"))
+                            column = SortColumn::Encoding;
+                        else
+                            column = SortColumn::String;
+
+                        this->sortStrings(column, sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending);
+                        this->m_sortNeeded = false;
+                    }
+
                     ImGui::TableHeadersRow();
 
                     ImGuiListClipper clipper;
@@ -169,7 +437,7 @@ namespace hex {
                     while (clipper.Step()) {
                         for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
                             auto &foundString = this->m_foundStrings[this->m_filterIndices[i]];
-                            auto string = readString(foundString);
+                            auto string = this->m_strings.get(this->m_filterIndices[i]);
 
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
@@ -177,15 +445,17 @@ namespace hex {
                                 EventManager::post<RequestSelectionChange>(Region { foundString.offset, foundString.size });
                             }
                             ImGui::PushID(i + 1);
-                            createStringContextMenu(foundString);
+                            createStringContextMenu(string);
                             ImGui::PopID();
                             ImGui::SameLine();
                             ImGui::Text("0x%08lx : 0x%08lx", foundString.offset, foundString.offset + foundString.size);
                             ImGui::TableNextColumn();
                             ImGui::Text("0x%04lx", foundString.size);
                             ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(StringExtractor::getEncodingName(foundString.encoding));
+                            ImGui::TableNextColumn();
 
-                            ImGui::Text("%s", string.c_str());
+                            ImGui::TextUnformatted(string.data(), string.data() + string.size());
                         }
                     }
                     clipper.End();
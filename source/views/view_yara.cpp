@@ -10,6 +10,8 @@
 
 #include <imgui_imhex_extensions.h>
 
+#include <GLFW/glfw3.h>
+
 namespace hex {
 
     ViewYara::ViewYara() : View("hex.view.yara.name") {
@@ -236,6 +238,9 @@ namespace hex {
             yr_compiler_destroy(compiler);
 
             this->m_matching = false;
+
+            // Wake up the main loop so the matches get drawn
+            glfwPostEmptyEvent();
         }).detach();
 
     }
@@ -7,6 +7,7 @@
 #include <hex/helpers/paths.hpp>
 #include <hex/helpers/logger.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <iostream>
@@ -272,9 +273,19 @@ namespace hex {
         while (!glfwWindowShouldClose(this->m_window)) {
             if (!glfwGetWindowAttrib(this->m_window, GLFW_VISIBLE) || glfwGetWindowAttrib(this->m_window, GLFW_ICONIFIED))
                 glfwWaitEvents();
-            else
-                glfwWaitEventsTimeout(ImGui::IsPopupOpen(ImGuiID(0), ImGuiPopupFlags_AnyPopupId) ? 0 : (this->m_lastFrameTime - glfwGetTime() + 1 / 5.0));
+            else if (this->needsRedraw())
+                glfwPollEvents();
+            else {
+                // Nothing changed since the last frame so there's no need to draw another one until new input arrives.
+                // An active text field still gets a few frames per second for its blinking cursor
+                if (ImGui::GetIO().WantTextInput)
+                    glfwWaitEventsTimeout(this->m_lastFrameTime - glfwGetTime() + 1 / 5.0);
+                else
+                    glfwWaitEvents();
 
+                // ImGui needs a few frames after an input to settle its hover and navigation state
+                this->m_settleFrames = 3;
+            }
 
             this->frameBegin();
             this->frame();
@@ -282,6 +293,20 @@ namespace hex {
         }
     }
 
+    bool Window::needsRedraw() {
+        if (this->m_settleFrames > 0) {
+            this->m_settleFrames--;
+            return true;
+        }
+
+        if (ImGui::IsPopupOpen(ImGuiID(0), ImGuiPopupFlags_AnyPopupId) || ImGui::IsAnyMouseDown() || !View::getDeferedCalls().empty())
+            return true;
+
+        return std::any_of(ContentRegistry::Views::getEntries().begin(), ContentRegistry::Views::getEntries().end(), [](auto &view) {
+            return view->needsRedraw();
+        });
+    }
+
     void Window::frameBegin() {
 
         ImGui_ImplOpenGL3_NewFrame();
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include <hex/helpers/utils.hpp>
+#include <hex/helpers/logger.hpp>
+
+#define TEST_SEQUENCE(name)                                                                                                         \
+    static bool TOKEN_CONCAT(testSequence, __LINE__)();                                                                             \
+    static ::hex::test::TestSequence TOKEN_CONCAT(testSequenceRegistration, __LINE__)(name, TOKEN_CONCAT(testSequence, __LINE__));  \
+    static bool TOKEN_CONCAT(testSequence, __LINE__)()
+
+#define TEST_ASSERT(condition)                                                                              \
+    do {                                                                                                    \
+        if (!(condition)) {                                                                                 \
+            ::hex::log::error("Assertion '{}' failed in {}:{}", #condition, __FILE__, __LINE__);            \
+            return false;                                                                                   \
+        }                                                                                                   \
+    } while (false)
+
+#define TEST_SUCCESS() return true
+
+namespace hex::test {
+
+    /* A named test that checks a piece of library code directly instead of going through the pattern language */
+    class TestSequence {
+    public:
+        using Function = std::function<bool()>;
+
+        TestSequence(const std::string &name, Function function) {
+            TestSequence::getTests().insert({ name, std::move(function) });
+        }
+
+        static std::map<std::string, Function>& getTests() {
+            static std::map<std::string, Function> tests;
+
+            return tests;
+        }
+    };
+
+}
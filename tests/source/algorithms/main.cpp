@@ -0,0 +1,38 @@
+#include <string>
+#include <cstdlib>
+
+#include <hex/helpers/logger.hpp>
+
+#include "test_sequence.hpp"
+
+using namespace hex::test;
+
+int test(int argc, char **argv) {
+    auto &tests = TestSequence::getTests();
+
+    // Check if a test to run has been provided
+    if (argc != 2) {
+        hex::log::fatal("Invalid number of arguments specified! {}", argc);
+        return EXIT_FAILURE;
+    }
+
+    // Check if that test exists
+    std::string testName = argv[1];
+    if (!tests.contains(testName)) {
+        hex::log::fatal("No test with name {} found!", testName);
+        return EXIT_FAILURE;
+    }
+
+    return tests[testName]() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    auto result = test(argc, argv);
+
+    if (result == EXIT_SUCCESS)
+        hex::log::info("Success!");
+    else
+        hex::log::info("Failed!");
+
+    return result;
+}
@@ -0,0 +1,190 @@
+#include <map>
+#include <random>
+#include <vector>
+
+#include <hex/providers/patch_tree.hpp>
+
+#include "test_sequence.hpp"
+
+using namespace hex::prv;
+
+namespace {
+
+    std::map<u64, u8> getRange(const std::map<u64, u8> &patches, u64 offset, size_t size) {
+        return { patches.lower_bound(offset), patches.lower_bound(offset + size) };
+    }
+
+    /* Extents have to be sorted, disjoint and may never cross a MaxExtentSize boundary */
+    bool hasValidExtents(const PatchTree &tree) {
+        bool valid = true;
+        u64 previousEnd = 0;
+
+        tree.forEach([&](u64 address, std::span<const u8> bytes) {
+            valid = valid && !bytes.empty() && address >= previousEnd;
+            valid = valid && address / PatchTree::MaxExtentSize == (address + bytes.size() - 1) / PatchTree::MaxExtentSize;
+
+            previousEnd = address + bytes.size();
+        });
+
+        return valid;
+    }
+
+    std::vector<std::pair<u64, size_t>> getExtents(const PatchTree &tree) {
+        std::vector<std::pair<u64, size_t>> extents;
+        tree.forEach([&](u64 address, std::span<const u8> bytes) { extents.emplace_back(address, bytes.size()); });
+
+        return extents;
+    }
+
+}
+
+TEST_SEQUENCE("PatchTreeExtentMerging") {
+    PatchTree tree;
+
+    // Bytes typed one after another end up in one extent per block
+    for (u64 address = 0x0FFE; address < 0x1003; address++) {
+        u8 value = address;
+        tree.write(address, &value, 1);
+    }
+
+    TEST_ASSERT(getExtents(tree) == (std::vector<std::pair<u64, size_t>> { { 0x0FFE, 2 }, { 0x1000, 3 } }));
+
+    // Large writes are split up at every block boundary and merged with touching extents inside of a block
+    std::vector<u8> data(0x2800, 0xAA);
+    tree.write(0x1002, data.data(), data.size());
+
+    TEST_ASSERT(getExtents(tree) == (std::vector<std::pair<u64, size_t>> { { 0x0FFE, 2 }, { 0x1000, 0x1000 }, { 0x2000, 0x1000 }, { 0x3000, 0x802 } }));
+    TEST_ASSERT(tree.size() == 2 + 0x2802);
+    TEST_ASSERT(tree.get(0x1001) == u8(0x01) && tree.get(0x1002) == u8(0xAA));
+
+    // Erasing inside of an extent leaves its head and tail behind
+    tree.erase(0x2100, 0x100);
+    TEST_ASSERT(getExtents(tree) == (std::vector<std::pair<u64, size_t>> { { 0x0FFE, 2 }, { 0x1000, 0x1000 }, { 0x2000, 0x100 }, { 0x2200, 0xE00 }, { 0x3000, 0x802 } }));
+    TEST_ASSERT(tree.size() == 2 + 0x2702);
+    TEST_ASSERT(!tree.contains(0x2150));
+
+    // Filling the gap merges everything inside of the block again
+    tree.write(0x2100, data.data(), 0x100);
+    TEST_ASSERT(getExtents(tree) == (std::vector<std::pair<u64, size_t>> { { 0x0FFE, 2 }, { 0x1000, 0x1000 }, { 0x2000, 0x1000 }, { 0x3000, 0x802 } }));
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("PatchTreeRandomEdits") {
+    std::mt19937_64 random(1);
+
+    for (u32 round = 0; round < 20; round++) {
+        PatchTree tree, other;
+        std::map<u64, u8> reference, otherReference;
+
+        for (u32 operation = 0; operation < 300; operation++) {
+            const u64 offset = random() % 20000;
+            const size_t size = 1 + random() % (random() % 4 == 0 ? 9000 : 40);
+
+            switch (random() % 5) {
+                case 0:
+                    tree.erase(offset, size);
+                    for (u64 i = 0; i < size; i++)
+                        reference.erase(offset + i);
+                    break;
+                case 1: {
+                    tree.replace(offset, size, other);
+
+                    for (u64 i = 0; i < size; i++)
+                        reference.erase(offset + i);
+                    for (const auto &[address, value] : getRange(otherReference, offset, size))
+                        reference[address] = value;
+                    break;
+                }
+                default: {
+                    std::vector<u8> bytes(size);
+                    for (auto &byte : bytes)
+                        byte = random();
+
+                    const bool toOther = random() % 3 == 0;
+                    auto &target = toOther ? other : tree;
+                    auto &targetReference = toOther ? otherReference : reference;
+
+                    target.write(offset, bytes.data(), bytes.size());
+                    for (u64 i = 0; i < size; i++)
+                        targetReference[offset + i] = bytes[i];
+                    break;
+                }
+            }
+
+            TEST_ASSERT(tree.size() == reference.size());
+        }
+
+        TEST_ASSERT(tree.toMap() == reference);
+        TEST_ASSERT(hasValidExtents(tree));
+
+        for (u32 query = 0; query < 200; query++) {
+            const u64 offset = random() % 21000;
+            const size_t size = 1 + random() % 5000;
+            const auto expected = getRange(reference, offset, size);
+
+            std::map<u64, u8> found;
+            bool clipped = true;
+            tree.forEachInRange(offset, size, [&](u64 address, std::span<const u8> bytes) {
+                clipped = clipped && address >= offset && address + bytes.size() <= offset + size;
+                for (u64 i = 0; i < bytes.size(); i++)
+                    found[address + i] = bytes[i];
+            });
+
+            TEST_ASSERT(clipped);
+            TEST_ASSERT(found == expected);
+            TEST_ASSERT(tree.overlaps(offset, size) == !expected.empty());
+
+            auto extracted = tree.extract(offset, size);
+            TEST_ASSERT(extracted.toMap() == expected);
+            TEST_ASSERT(extracted.size() == expected.size());
+            TEST_ASSERT(hasValidExtents(extracted));
+
+            const u64 address = random() % 21000;
+            const auto value = tree.get(address);
+            TEST_ASSERT(value.has_value() == reference.contains(address));
+            TEST_ASSERT(!value.has_value() || *value == reference[address]);
+        }
+    }
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("PatchTreeSharing") {
+    std::mt19937_64 random(2);
+
+    PatchTree tree;
+    std::vector<PatchTree> snapshots;
+    std::vector<std::map<u64, u8>> references;
+
+    for (u32 operation = 0; operation < 500; operation++) {
+        const u64 offset = random() % 30000;
+        const size_t size = 1 + random() % 3000;
+
+        if (random() % 4 == 0) {
+            tree.erase(offset, size);
+        } else {
+            std::vector<u8> bytes(size, u8(operation));
+            tree.write(offset, bytes.data(), bytes.size());
+        }
+
+        snapshots.push_back(tree);
+        references.push_back(tree.toMap());
+    }
+
+    // Copies share their nodes with the original but never see any of its later changes
+    for (u64 i = 0; i < snapshots.size(); i++) {
+        TEST_ASSERT(snapshots[i].toMap() == references[i]);
+        TEST_ASSERT(snapshots[i].size() == references[i].size());
+    }
+
+    // Extracted ranges stay valid when the tree they came from is modified or cleared
+    auto extracted = tree.extract(1000, 10000);
+    auto expected = getRange(tree.toMap(), 1000, 10000);
+    tree.clear();
+
+    TEST_ASSERT(tree.empty() && tree.size() == 0);
+    TEST_ASSERT(extracted.toMap() == expected);
+
+    TEST_SUCCESS();
+}
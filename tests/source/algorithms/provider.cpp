@@ -0,0 +1,66 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "test_provider.hpp"
+#include "test_sequence.hpp"
+
+using namespace hex::test;
+
+namespace {
+
+    /* Finishes every read on a separate thread after a delay, like a provider reading ahead from disk */
+    class AsyncTestProvider : public TestProvider {
+    public:
+        std::future<void> readAsync(std::vector<ReadRequest> requests, bool overlays) override {
+            this->m_startedReads++;
+
+            // Unlike std::async's future, this one doesn't block in its destructor
+            std::promise<void> done;
+            auto future = done.get_future();
+
+            std::thread([this, requests = std::move(requests), overlays, done = std::move(done)]() mutable {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+                for (const auto &request : requests)
+                    this->read(request.offset, request.buffer, request.size, overlays);
+
+                this->m_finishedReads++;
+                done.set_value();
+            }).detach();
+
+            return future;
+        }
+
+        std::atomic<u32> m_startedReads = 0, m_finishedReads = 0;
+    };
+
+}
+
+TEST_SEQUENCE("ProviderReadChunkedStopEarly") {
+    AsyncTestProvider provider;
+    constexpr size_t ChunkSize = 0x10;
+
+    std::vector<u8> expected(ChunkSize);
+    provider.read(0, expected.data(), expected.size());
+
+    u32 chunks = 0;
+    bool firstChunkValid = false;
+    provider.readChunked(0, provider.getActualSize(), [&](u64 address, const u8 *data, size_t size) {
+        firstChunkValid = address == 0 && std::vector<u8>(data, data + size) == expected;
+        chunks++;
+
+        return false;
+    }, ChunkSize);
+
+    TEST_ASSERT(chunks == 1);
+    TEST_ASSERT(firstChunkValid);
+
+    // The second chunk was already being read when the callback stopped, it must have finished before readChunked returned
+    TEST_ASSERT(provider.m_startedReads == 2);
+    TEST_ASSERT(provider.m_finishedReads == provider.m_startedReads);
+
+    TEST_SUCCESS();
+}
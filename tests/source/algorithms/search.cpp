@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <hex/helpers/search.hpp>
+
+#include "test_provider.hpp"
+#include "test_sequence.hpp"
+
+using namespace hex::test;
+using namespace hex::search;
+using hex::Region;
+
+namespace {
+
+    /* Repeats the test data so scans span several chunks */
+    class RepeatedTestProvider : public TestProvider {
+    public:
+        constexpr static size_t Repetitions = 16;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override {
+            const size_t dataSize = TestProvider::getActualSize();
+
+            auto bytes = static_cast<u8*>(buffer);
+            while (size > 0) {
+                const size_t readSize = std::min<u64>(size, dataSize - (offset % dataSize));
+                TestProvider::readRaw(offset % dataSize, bytes, readSize);
+
+                offset += readSize;
+                bytes += readSize;
+                size -= readSize;
+            }
+        }
+
+        size_t getActualSize() override {
+            return TestProvider::getActualSize() * Repetitions;
+        }
+    };
+
+    std::vector<u8> randomBytes(std::mt19937_64 &random, size_t size, const std::string &alphabet) {
+        std::vector<u8> bytes(size);
+        for (auto &byte : bytes)
+            byte = alphabet.empty() ? u8(random()) : u8(alphabet[random() % alphabet.size()]);
+
+        return bytes;
+    }
+
+    std::vector<size_t> findSequenceReference(const std::vector<u8> &data, size_t startLimit, const std::vector<u8> &sequence, const std::vector<u8> &mask) {
+        std::vector<size_t> offsets;
+
+        for (size_t offset = 0; offset + sequence.size() <= data.size() && offset < startLimit; offset++) {
+            bool matches = true;
+            for (size_t i = 0; i < sequence.size() && matches; i++)
+                matches = (data[offset + i] & mask[i]) == (sequence[i] & mask[i]);
+
+            if (matches)
+                offsets.push_back(offset);
+        }
+
+        return offsets;
+    }
+
+    /* Leftmost-longest, non-overlapping matches found by trying every start and end */
+    std::vector<Region> findRegexReference(const std::string &data, const std::regex &regex) {
+        std::vector<Region> matches;
+
+        size_t position = 0;
+        while (position < data.size()) {
+            std::optional<Region> match;
+
+            for (size_t start = position; start < data.size() && !match.has_value(); start++) {
+                for (size_t end = data.size(); end > start; end--) {
+                    if (std::regex_match(data.begin() + start, data.begin() + end, regex)) {
+                        match = Region { start, end - start };
+                        break;
+                    }
+                }
+            }
+
+            if (!match.has_value())
+                break;
+
+            matches.push_back(*match);
+            position = match->address + match->size;
+        }
+
+        return matches;
+    }
+
+}
+
+TEST_SEQUENCE("SearchSequenceMatcher") {
+    std::mt19937_64 random(17);
+
+    // Sizes above 32 bytes run both the AVX2 and the SSE2 loop before the scalar tail, whichever the CPU supports
+    for (u32 round = 0; round < 3000; round++) {
+        const auto data = randomBytes(random, random() % 200, round % 2 == 0 ? std::string("abAB\x00\xFF", 6) : "");
+        const size_t startLimit = random() % 4 == 0 ? random() % (data.size() + 1) : data.size();
+
+        std::vector<u8> sequence, mask;
+        if (round % 3 == 0 && data.size() > 8) {
+            // Sequences taken from the data so there's at least one match
+            const size_t offset = random() % (data.size() - 8);
+            sequence.assign(data.begin() + offset, data.begin() + offset + 1 + random() % 8);
+        } else {
+            sequence = randomBytes(random, 1 + random() % 4, std::string("abAB\x00\xFF", 6));
+        }
+
+        for (size_t i = 0; i < sequence.size(); i++) {
+            switch (random() % 4) {
+                case 0: mask.push_back(0x00); break;
+                case 1: mask.push_back(0xF0); break;
+                default: mask.push_back(0xFF); break;
+            }
+        }
+        if (round % 5 == 0)
+            mask.assign(sequence.size(), 0xFF);
+
+        std::vector<size_t> offsets;
+        SequenceMatcher(sequence, mask).find(data, startLimit, [&](size_t offset) { offsets.push_back(offset); });
+
+        TEST_ASSERT(offsets == findSequenceReference(data, startLimit, sequence, mask));
+    }
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("SearchIgnoreCase") {
+    std::mt19937_64 random(18);
+
+    for (u32 round = 0; round < 2000; round++) {
+        const auto data = randomBytes(random, random() % 300, std::string("aAbBzZ@[`{1\x00", 12));
+        const auto textBytes = randomBytes(random, 1 + random() % 6, "aAbBzZ@[`{1");
+        const std::string text(textBytes.begin(), textBytes.end());
+
+        const auto encoding = TextEncoding(round % 3);
+        auto pattern = encodeText(text, encoding, true);
+        TEST_ASSERT(pattern.has_value());
+
+        std::vector<size_t> offsets;
+        SequenceMatcher(pattern->bytes, pattern->mask).find(data, data.size(), [&](size_t offset) { offsets.push_back(offset); });
+
+        TEST_ASSERT(offsets == findSequenceReference(data, data.size(), pattern->bytes, pattern->mask));
+    }
+
+    // Only the case of letters is ignored
+    auto pattern = encodeText("a@", TextEncoding::UTF8, true);
+    TEST_ASSERT(pattern.has_value());
+
+    const std::string data = "A@a@a`A`";
+    std::vector<size_t> offsets;
+    SequenceMatcher(pattern->bytes, pattern->mask).find({ reinterpret_cast<const u8*>(data.data()), data.size() }, data.size(), [&](size_t offset) { offsets.push_back(offset); });
+    TEST_ASSERT(offsets == (std::vector<size_t> { 0, 2 }));
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("SearchScanProviderStitching") {
+    RepeatedTestProvider provider;
+    const size_t size = provider.getActualSize();
+
+    std::vector<u8> data(size);
+    provider.readRaw(0, data.data(), data.size());
+
+    std::mt19937_64 random(19);
+
+    // Sequences crossing the 1 MiB chunk boundaries have to be found across them, including ones longer than a whole chunk
+    std::vector<std::pair<u64, size_t>> sequences = { { 0x10'0000 - 1, 2 }, { 0x20'0000 - 0x10, 0x40 }, { 0x0F'F000, 0x18'0000 }, { 0, 1 } };
+    for (u32 i = 0; i < 10; i++) {
+        const size_t sequenceSize = 1 + random() % 0x100;
+        sequences.emplace_back(0x10'0000 * (1 + random() % 2) - random() % sequenceSize, sequenceSize);
+    }
+
+    for (const auto &[offset, sequenceSize] : sequences) {
+        std::vector<u8> sequence(data.begin() + offset, data.begin() + offset + sequenceSize);
+        SequenceMatcher matcher(sequence);
+
+        std::vector<Region> matches;
+        u64 lastScannedUntil = 0;
+        bool ascending = true;
+
+        scanProvider(&provider, provider.takeSnapshot(), 0, size, sequenceSize, [&](u64 address, std::span<const u8> chunk, size_t startLimit, std::vector<Region> &chunkMatches) {
+            matcher.find(chunk, startLimit, [&](size_t matchOffset) { chunkMatches.push_back({ address + matchOffset, sequenceSize }); });
+        }, [&](std::vector<Region> &chunkMatches, u64 scannedUntil) {
+            ascending = ascending && scannedUntil >= lastScannedUntil;
+            lastScannedUntil = scannedUntil;
+
+            matches.insert(matches.end(), chunkMatches.begin(), chunkMatches.end());
+            return true;
+        });
+
+        std::vector<Region> expected;
+        for (size_t match : findSequenceReference(data, size, sequence, std::vector<u8>(sequenceSize, 0xFF)))
+            expected.push_back({ match, sequenceSize });
+
+        // The test data repeats, so every sequence is found once per repetition it fits into
+        TEST_ASSERT(expected.size() >= (size - offset - sequenceSize) / TestProvider().getActualSize());
+        TEST_ASSERT(ascending && lastScannedUntil == size);
+        TEST_ASSERT(matches.size() == expected.size());
+        TEST_ASSERT(std::equal(matches.begin(), matches.end(), expected.begin(), [](const Region &left, const Region &right) {
+            return left.address == right.address && left.size == right.size;
+        }));
+    }
+
+    // Returning false stops scanning after the current chunk
+    u32 calls = 0;
+    scanProvider(&provider, provider.takeSnapshot(), 0, size, 4, [](u64, std::span<const u8>, size_t, std::vector<Region> &) { }, [&](std::vector<Region> &, u64) {
+        calls++;
+        return false;
+    });
+    TEST_ASSERT(calls == 1);
+
+    // Patches are read from the snapshot, edits made after taking it aren't seen by the scan
+    const std::vector<u8> marker = { 0xDE, 0xAD, 0x00, 0xBE, 0xEF, 0xFF, 0x12, 0x34 };
+    provider.addPatch(0x10'0000 - 3, marker.data(), marker.size());
+    auto snapshot = provider.takeSnapshot();
+    provider.undo();
+
+    SequenceMatcher markerMatcher(marker);
+    std::vector<Region> markerMatches;
+    scanProvider(&provider, snapshot, 0, size, marker.size(), [&](u64 address, std::span<const u8> chunk, size_t startLimit, std::vector<Region> &chunkMatches) {
+        markerMatcher.find(chunk, startLimit, [&](size_t matchOffset) { chunkMatches.push_back({ address + matchOffset, marker.size() }); });
+    }, [&](std::vector<Region> &chunkMatches, u64) {
+        markerMatches.insert(markerMatches.end(), chunkMatches.begin(), chunkMatches.end());
+        return true;
+    });
+    TEST_ASSERT(markerMatches.size() == 1 && markerMatches[0].address == 0x10'0000 - 3);
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("SearchMultiSequenceMatcher") {
+    std::mt19937_64 random(20);
+
+    for (u32 round = 0; round < 500; round++) {
+        // A small alphabet makes sequences prefixes and suffixes of each other
+        const auto data = randomBytes(random, random() % 400, "abc");
+        const size_t startLimit = random() % 4 == 0 ? random() % (data.size() + 1) : data.size();
+
+        std::vector<std::vector<u8>> sequences;
+        for (u32 i = 0; i < 1 + random() % 8; i++)
+            sequences.push_back(randomBytes(random, 1 + random() % 5, "abc"));
+
+        std::vector<std::pair<size_t, u32>> matches;
+        MultiSequenceMatcher(sequences).find(data, startLimit, [&](size_t offset, u32 index) { matches.emplace_back(offset, index); });
+
+        std::vector<std::pair<size_t, u32>> expected;
+        for (u32 index = 0; index < sequences.size(); index++) {
+            for (size_t offset : findSequenceReference(data, startLimit, sequences[index], std::vector<u8>(sequences[index].size(), 0xFF)))
+                expected.emplace_back(offset, index);
+        }
+
+        std::sort(matches.begin(), matches.end());
+        std::sort(expected.begin(), expected.end());
+        TEST_ASSERT(matches == expected);
+    }
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("SearchRegex") {
+    const std::vector<std::string> patterns = {
+        "a", "ab", "a|b", "ab|a", "a*b", "a+", "(ab)+", "a?b", "a{2,3}", "a{2}", "b{1,}",
+        "[ab]c", "[^a]+", "a.c", ".b", "(a|bc)*d", "\\d+", "\\w+", "a\\s", "\\x61b", "(a|ab)(c|bcd)"
+    };
+
+    std::mt19937_64 random(21);
+
+    for (const auto &pattern : patterns) {
+        auto matcher = RegexMatcher::compile(pattern, TextEncoding::UTF8, false);
+        TEST_ASSERT(matcher.has_value());
+
+        const std::regex regex(pattern);
+        for (u32 round = 0; round < 20; round++) {
+            const auto bytes = randomBytes(random, random() % 40, "abcd1 ");
+            const std::string data(bytes.begin(), bytes.end());
+
+            std::vector<Region> matches;
+            matcher->find(bytes, bytes.size(), [&](size_t offset, size_t size) { matches.push_back({ offset, size }); });
+
+            auto expected = findRegexReference(data, regex);
+            TEST_ASSERT(matches.size() == expected.size());
+            TEST_ASSERT(std::equal(matches.begin(), matches.end(), expected.begin(), [](const Region &left, const Region &right) {
+                return left.address == right.address && left.size == right.size;
+            }));
+        }
+    }
+
+    // Matches only have to start before the limit
+    auto matcher = RegexMatcher::compile("a+", TextEncoding::UTF8, false);
+    const std::string data = "aaxaaa";
+    std::vector<Region> matches;
+    matcher->find({ reinterpret_cast<const u8*>(data.data()), data.size() }, 4, [&](size_t offset, size_t size) { matches.push_back({ offset, size }); });
+    TEST_ASSERT(matches.size() == 2 && matches[1].address == 3 && matches[1].size == 3);
+
+    // Case insensitive UTF-16 patterns match both cases of each code unit
+    matcher = RegexMatcher::compile("ab", TextEncoding::UTF16LE, true);
+    const std::string wide = std::string("xA\0b\0a\0B", 8);
+    matches.clear();
+    matcher->find({ reinterpret_cast<const u8*>(wide.data()), wide.size() }, wide.size(), [&](size_t offset, size_t size) { matches.push_back({ offset, size }); });
+    TEST_ASSERT(matches.size() == 1 && matches[0].address == 1 && matches[0].size == 4);
+
+    TEST_ASSERT(!RegexMatcher::compile("(a", TextEncoding::UTF8, false).has_value());
+    TEST_ASSERT(!RegexMatcher::compile("a{2000}", TextEncoding::UTF8, false).has_value());
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("SearchResults") {
+    std::mt19937_64 random(22);
+
+    SearchResults results;
+    std::vector<Region> expected;
+
+    // Gaps of all sizes need varints of different lengths, a few results have a different size than the first one
+    u64 address = 0;
+    for (u32 i = 0; i < SearchResults::PageSize * 10 + 17; i++) {
+        switch (random() % 4) {
+            case 0: address += random() % 0x80; break;
+            case 1: address += random() % 0x1'0000; break;
+            case 2: address += random() % 0x1'0000'0000; break;
+            default: address += 1; break;
+        }
+
+        const Region region = { address, random() % 10 == 0 ? 1 + random() % 0x1000 : 4 };
+        results.append(region);
+        expected.push_back(region);
+    }
+
+    TEST_ASSERT(results.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        const auto region = results.get(i);
+        TEST_ASSERT(region.address == expected[i].address && region.size == expected[i].size);
+    }
+
+    auto lowerBound = [&](u64 address) -> size_t {
+        return std::lower_bound(expected.begin(), expected.end(), address, [](const Region &region, u64 address) { return region.address < address; }) - expected.begin();
+    };
+
+    for (u32 i = 0; i < 2000; i++) {
+        const u64 query = i % 2 == 0 ? expected[random() % expected.size()].address + (random() % 3) - 1 : random() % (address + 0x100);
+        TEST_ASSERT(results.lowerBound(query) == lowerBound(query));
+    }
+    TEST_ASSERT(results.lowerBound(0) == 0);
+    TEST_ASSERT(results.lowerBound(address + 1) == expected.size());
+
+    results.clear();
+    TEST_ASSERT(results.size() == 0 && results.lowerBound(0) == 0);
+
+    TEST_SUCCESS();
+}
@@ -0,0 +1,118 @@
+#include <map>
+#include <random>
+#include <vector>
+
+#include "test_provider.hpp"
+#include "test_sequence.hpp"
+
+using namespace hex::test;
+
+TEST_SEQUENCE("UndoRedo") {
+    std::mt19937_64 random(3);
+
+    TestProvider provider;
+    std::vector<std::map<u64, u8>> states = { { } };
+
+    for (u32 edit = 0; edit < 200; edit++) {
+        const u64 offset = random() % 0x8000;
+        std::vector<u8> bytes(2 + random() % 0x800);
+        for (auto &byte : bytes)
+            byte = random();
+
+        provider.addPatch(offset, bytes.data(), bytes.size());
+        states.push_back(provider.getPatches().toMap());
+    }
+
+    for (u32 i = states.size() - 1; i > 0; i--) {
+        TEST_ASSERT(provider.canUndo());
+        provider.undo();
+        TEST_ASSERT(provider.getPatches().toMap() == states[i - 1]);
+    }
+    TEST_ASSERT(!provider.canUndo());
+
+    for (u32 i = 1; i < states.size(); i++) {
+        TEST_ASSERT(provider.canRedo());
+        provider.redo();
+        TEST_ASSERT(provider.getPatches().toMap() == states[i]);
+    }
+    TEST_ASSERT(!provider.canRedo());
+
+    // A new edit after undoing drops everything that could have been redone
+    provider.undo();
+    u8 value = 0x42;
+    provider.addPatch(0, &value, 1);
+    TEST_ASSERT(!provider.canRedo());
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("UndoCoalescing") {
+    TestProvider provider;
+
+    // Bytes typed right after each other are undone in one step
+    for (u64 address = 0x100; address < 0x110; address++) {
+        u8 value = address;
+        provider.addPatch(address, &value, 1);
+    }
+
+    provider.undo();
+    TEST_ASSERT(provider.getPatches().empty());
+    TEST_ASSERT(!provider.canUndo());
+
+    provider.redo();
+    TEST_ASSERT(provider.getPatches().size() == 0x10);
+
+    // Typing somewhere else starts a new step
+    u8 value = 0xFF;
+    provider.addPatch(0x500, &value, 1);
+    provider.undo();
+    TEST_ASSERT(provider.getPatches().size() == 0x10 && !provider.getPatches().contains(0x500));
+
+    // A single step never grows past 0x100 bytes
+    for (u64 address = 0x1000; address < 0x1101; address++)
+        provider.addPatch(address, &value, 1);
+
+    provider.undo();
+    TEST_ASSERT(provider.getPatches().size() == 0x10 + 0x100);
+    provider.undo();
+    TEST_ASSERT(provider.getPatches().size() == 0x10);
+
+    TEST_SUCCESS();
+}
+
+TEST_SEQUENCE("UndoMemoryLimit") {
+    TestProvider provider;
+    provider.setUndoMemoryLimit(0x1'0000);
+
+    std::vector<u8> first(0x10'0000, 0x11), second(0x10'0000, 0x22);
+
+    // Edits larger than the limit still have to be undoable
+    provider.addPatch(0, first.data(), first.size());
+    provider.addPatch(0, second.data(), second.size());
+
+    TEST_ASSERT(provider.canUndo());
+    provider.undo();
+    TEST_ASSERT(provider.getPatches().get(0) == u8(0x11) && provider.getPatches().size() == first.size());
+
+    // Only the newest step was kept, the older one didn't fit into the limit next to it
+    TEST_ASSERT(!provider.canUndo());
+    TEST_ASSERT(provider.canRedo());
+    provider.redo();
+    TEST_ASSERT(provider.getPatches().get(0) == u8(0x22) && provider.getPatches().size() == second.size());
+
+    // Bytes shared with the current patches don't count towards the limit
+    TestProvider fresh;
+    fresh.setUndoMemoryLimit(0x2000);
+    for (u64 i = 0; i < 8; i++)
+        fresh.addPatch(i * 0x10'0000, first.data(), first.size());
+
+    u32 steps = 0;
+    while (fresh.canUndo()) {
+        fresh.undo();
+        steps++;
+    }
+    TEST_ASSERT(steps == 8);
+    TEST_ASSERT(fresh.getPatches().empty());
+
+    TEST_SUCCESS();
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <hex/helpers/logger.hpp>
+
+#include "providers/file_provider.hpp"
+
+/*
+ * Reads a file sequentially through FileProvider::read, once without patches and once with 10k patches applied.
+ * Usage: provider_benchmark [size in MiB, default 1024]
+ */
+
+namespace {
+
+    constexpr size_t ChunkSize = 0x1'0000;
+    constexpr u64 PatchCount = 10'000;
+
+    void createFile(const std::string &path, size_t size) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        std::vector<char> block(0x10'0000, 0x41);
+
+        for (size_t written = 0; written < size; written += block.size())
+            file.write(block.data(), std::min(block.size(), size - written));
+    }
+
+    void measure(hex::prv::Provider &provider, size_t size, const char *name) {
+        std::vector<u8> buffer(ChunkSize);
+        u64 checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (u64 offset = 0; offset < size; offset += buffer.size()) {
+            provider.read(offset, buffer.data(), std::min(buffer.size(), size - offset));
+            checksum += buffer[7];
+        }
+        auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        hex::log::info("{}: {:.0f} ms ({:.0f} MiB/s, checksum {})", name, milliseconds, (size / double(1 << 20)) / (milliseconds / 1000), checksum);
+    }
+
+}
+
+int main(int argc, char **argv) {
+    size_t size = size_t(argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 1024) << 20;
+    std::string path = (std::filesystem::temp_directory_path() / "imhex_provider_benchmark.bin").string();
+
+    createFile(path, size);
+
+    {
+        hex::prv::FileProvider provider(path);
+        if (!provider.isAvailable()) {
+            hex::log::fatal("Failed to open {}", path);
+            return EXIT_FAILURE;
+        }
+
+        measure(provider, size, "No patches");
+
+        u8 patch[16] = { };
+        for (u64 i = 0; i < PatchCount; i++)
+            provider.write((i * ChunkSize + 7) % size, patch, sizeof(patch));
+
+        measure(provider, size, "10k patches");
+    }
+
+    std::filesystem::remove(path);
+
+    return EXIT_SUCCESS;
+}
@@ -8,6 +8,7 @@
 #include <hex/pattern_language/pattern_language.hpp>
 #include <hex/pattern_language/evaluator.hpp>
 #include <hex/pattern_language/ast_node.hpp>
+#include <hex/providers/cached_provider.hpp>
 #include <hex/api/content_registry.hpp>
 
 #include "test_provider.hpp"
@@ -35,8 +36,8 @@ int test(int argc, char **argv) {
             delete value;
     };
 
-    // Check if a test to run has been provided
-    if (argc != 2) {
+    // Check if a test to run has been provided, optionally followed by "cached" to read through a block cache
+    if (argc != 2 && !(argc == 3 && std::string(argv[2]) == "cached")) {
         hex::log::fatal("Invalid number of arguments specified! {}", argc);
         return EXIT_FAILURE;
     }
@@ -51,7 +52,11 @@ int test(int argc, char **argv) {
     const auto &currTest = testPatterns[testName];
     bool failing = currTest->getMode() == Mode::Failing;
 
-    auto provider = new TestProvider();
+    hex::prv::Provider *provider;
+    if (argc == 3)
+        provider = new CachedProvider<TestProvider>();
+    else
+        provider = new TestProvider();
     ON_SCOPE_EXIT { delete provider; };
     if (provider->getActualSize() == 0) {
         hex::log::fatal("Failed to load Testing Data");